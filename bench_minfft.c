@@ -0,0 +1,155 @@
+
+/* benchmark of the minfft library */
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "minfft.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if MINFFT_SINGLE
+#define MINFFT_PREC_TYPE  "single"
+#elif MINFFT_EXTENDED
+#define MINFFT_PREC_TYPE  "long double"
+#else
+#define MINFFT_PREC_TYPE  "double"
+#endif
+
+/* minimum measurement time in seconds */
+#define MIN_TIME 0.5
+
+
+/* wall clock time in seconds */
+static double now(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER f, c;
+    QueryPerformanceFrequency(&f);
+    QueryPerformanceCounter(&c);
+    return (double)c.QuadPart / (double)f.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+#endif
+}
+
+/* seconds per complex DFT */
+static double time_dft(minfft_aux *a, minfft_cmpl *x, minfft_cmpl *y)
+{
+    long k, iter = 1;
+    double t0, t;
+
+    for (;;) {
+        t0 = now();
+        for (k = 0; k < iter; ++k)
+            minfft_dft(x, y, a);
+        t = now() - t0;
+        if (t >= MIN_TIME)
+            return t / iter;
+        iter *= 2;
+    }
+}
+
+/* seconds per real DFT */
+static double time_realdft(minfft_aux *a, minfft_real *x, minfft_cmpl *z)
+{
+    long k, iter = 1;
+    double t0, t;
+
+    for (;;) {
+        t0 = now();
+        for (k = 0; k < iter; ++k)
+            minfft_realdft(x, z, a);
+        t = now() - t0;
+        if (t >= MIN_TIME)
+            return t / iter;
+        iter *= 2;
+    }
+}
+
+/* thread scaling of multi-dimensional complex and real DFT */
+static int bench_threads(int maxthreads, int d, int *Ns)
+{
+    minfft_aux *ac, *ar;
+    minfft_cmpl *x, *y;
+    long j, p = 1;
+    int nt, i;
+    double tc1 = 0, tr1 = 0, tc, tr;
+
+    for (i = 0; i < d; ++i)
+        p *= Ns[i];
+    x = (minfft_cmpl*)malloc(p * sizeof(minfft_cmpl));
+    y = (minfft_cmpl*)malloc(p * sizeof(minfft_cmpl));
+    ac = minfft_mkaux_dft(d, Ns);
+    ar = minfft_mkaux_realdft(d, Ns);
+    if (!x || !y || !ac || !ar) {
+        fprintf(stderr, "error: cannot prepare transforms\n");
+        return 1;
+    }
+    for (j = 0; j < 2 * p; ++j)
+        ((minfft_real*)x)[j] = (minfft_real)rand() / RAND_MAX;
+
+    printf("threads, complex dft [ms], speedup, real dft [ms], speedup\n");
+    for (nt = 1; nt <= maxthreads; ++nt) {
+        if (minfft_set_threads(ac, nt) || minfft_set_threads(ar, nt)) {
+            fprintf(stderr, "error: cannot use %d threads\n", nt);
+            return 1;
+        }
+        tc = time_dft(ac, x, y);
+        tr = time_realdft(ar, (minfft_real*)x, y);
+        if (nt == 1) {
+            tc1 = tc;
+            tr1 = tr;
+        }
+        printf("%d, %.3f, %.2f, %.3f, %.2f\n",
+            nt, 1e3 * tc, tc1 / tc, 1e3 * tr, tr1 / tr);
+    }
+
+    minfft_free_aux(ac);
+    minfft_free_aux(ar);
+    free(x);
+    free(y);
+    return 0;
+}
+
+
+int main(int argc, char *argv[])
+{
+    int maxthreads = 1;
+    int d, Ns[3];
+
+#ifdef _OPENMP
+    maxthreads = omp_get_num_procs();
+#endif
+    if (2 < argc && !strcmp(argv[1], "-t")) {
+        maxthreads = atoi(argv[2]);
+        argc -= 2;
+        argv += 2;
+    }
+    if (argc < 3 || argc > 4 || maxthreads < 1) {
+        fprintf(stderr, "usage: %s [-t <maxthreads>] <N1> <N2> [<N3>]\n", argv[0]);
+        fprintf(stderr, "  measures multi-dimensional transforms with 1 .. maxthreads threads\n");
+        return 1;
+    }
+    for (d = 0; d < argc - 1; ++d)
+        Ns[d] = atoi(argv[d + 1]);
+
+    printf("minfft %s-precision benchmark\n", MINFFT_PREC_TYPE);
+    return bench_threads(maxthreads, d, Ns);
+}
+
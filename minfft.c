@@ -2,1186 +2,1300 @@
 // Copyright (c) 2016-2022 Alexander Mukhin
 // SPDX-License-Identifier: MIT
 
-#include "minfft.h"
+// the kernels built with the flags of this file
+#define MINFFT_KERNELS minfft_kernels_default
+#include "minfft_kernels.h"
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
+#if MINFFT_DISPATCH && defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
-// constants
-static const minfft_real pi=3.141592653589793238462643383279502884L;
-static const minfft_real sqrt2=1.414213562373095048801688724209698079L;
-static const minfft_real invsqrt2=0.707106781186547524400844362104849039L;
-
-// aux structure
-struct minfft_aux {
-	int N; // number of elements to transform
-	void *t; // temporary buffer
-	void *e; // exponent vector
-	struct minfft_aux *sub1; // subtransform structure
-	struct minfft_aux *sub2; // subtransform structure
-};
+// alignment of workspace parts
+#define WS_ALIGN 64
 
 // *** higher-order functions ***
 
-// a pointer to a strided 1d complex transform routine
-typedef
-void (*s_cx_1d_t)
-(minfft_cmpl*,minfft_cmpl*,int,const minfft_aux*);
+// size of own part of the workspace, rounded up for alignment
+static size_t
+ws_part (size_t sz) {
+	return (sz+WS_ALIGN-1)/WS_ALIGN*WS_ALIGN;
+}
+
+// size of the block buffer of a task
+static size_t
+blk_size (const minfft_aux *a) {
+	size_t N1,N2; // lengths of subtransforms
+	if (a->sub2==NULL || a->alg==ALG_BAILEY)
+		return 0;
+	N1=a->sub1->N;
+	N2=a->sub2->N;
+	return ws_part(BLK*(N1>N2?N1:N2)*sizeof(minfft_cmpl));
+}
+
+// copy a tile of b sequences of N complex numbers,
+// element k of sequence j being at x[sxj*j+sxk*k] and y[syj*j+syk*k]
+static void
+tile_cx (minfft_cmpl *x, ptrdiff_t sxj, ptrdiff_t sxk, minfft_cmpl *y, ptrdiff_t syj, ptrdiff_t syk, ptrdiff_t b, ptrdiff_t N) {
+	minfft_real *xr=(minfft_real*)x,*xi=xr+1;
+	minfft_real *yr=(minfft_real*)y,*yi=yr+1;
+	ptrdiff_t j,k; // counters
+	for (k=0; k<N; ++k)
+		for (j=0; j<b; ++j) {
+			// y[syj*j+syk*k]=x[sxj*j+sxk*k];
+			yr[2*(syj*j+syk*k)]=xr[2*(sxj*j+sxk*k)];
+			yi[2*(syj*j+syk*k)]=xi[2*(sxj*j+sxk*k)];
+		}
+}
+
+// copy a tile of b sequences of N real numbers, as above
+static void
+tile_rx (const minfft_real *x, ptrdiff_t sxj, ptrdiff_t sxk, minfft_real *y, ptrdiff_t syj, ptrdiff_t syk, ptrdiff_t b, ptrdiff_t N) {
+	ptrdiff_t j,k; // counters
+	for (k=0; k<N; ++k)
+		for (j=0; j<b; ++j)
+			y[syj*j+syk*k]=x[sxj*j+sxk*k];
+}
+
+// a stage of a multi-dimensional transform,
+// which is a loop of independent subtransforms
+struct stage {
+	void (*sub)(const struct stage*,ptrdiff_t,void*); // n-th block of subtransforms
+	void *x; // stage input
+	void *y; // stage output
+	ptrdiff_t sy; // output stride
+	const minfft_aux *a; // aux data of the transform
+	s_cx_1d_t cx; // strided 1d complex transform routine
+	s_rx_1d_t rx; // strided 1d real transform routine
+	ptrdiff_t N; // number of blocks of subtransforms
+	void *ws; // workspace of subtransforms
+	size_t wsz; // size of the workspace of one task
+	size_t bsz; // size of the block buffer at its beginning
+};
+
+// part of a stage done by a single task
+static void
+stage_task (void *arg, int k) {
+	const struct stage *s=arg;
+	int nt=s->a->nt; // number of tasks
+	ptrdiff_t n,n1; // counters
+	void *ws=(char*)s->ws+k*s->wsz; // workspace of the task
+	n1=s->N/nt*(k+1)+s->N%nt*(k+1)/nt;
+	for (n=s->N/nt*k+s->N%nt*k/nt; n<n1; ++n)
+		(*s->sub)(s,n,ws);
+}
+
+// make a stage
+static struct stage
+make_stage (const minfft_aux *a, void *ws) {
+	struct stage s={NULL,NULL,NULL,0,NULL,NULL,NULL,0,NULL,0,0};
+	size_t sz1,sz2; // workspace sizes of subtransforms
+	s.a=a;
+	s.ws=sub_ws(ws,a);
+	s.bsz=blk_size(a);
+	if (a->nt>1) {
+		sz1=minfft_workspace_size(a->sub1);
+		sz2=minfft_workspace_size(a->sub2);
+		s.wsz=ws_part(s.bsz+(sz1>sz2?sz1:sz2));
+	}
+	return s;
+}
+
+// run a stage of N subtransforms in blocks, splitting it between tasks
+static void
+run_stage (struct stage *s, ptrdiff_t N) {
+	const minfft_aux *a=s->a;
+	s->N=(N+BLK-1)/BLK;
+	if (a->nt>1)
+		(*a->disp)(stage_task,s,a->nt,a->dctx);
+	else
+		stage_task(s,0);
+}
+
+// prototypes
+inline static void
+mkcx (minfft_cmpl*, minfft_cmpl*, ptrdiff_t, const minfft_aux*, void*, s_cx_1d_t);
+inline static void
+mkrx (minfft_real*, minfft_real*, ptrdiff_t, const minfft_aux*, void*, s_rx_1d_t);
+
+// strided complex transforms of a block of contiguous hyperplanes
+static void
+cx_plane (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N2-n0<BLK?N2-n0:BLK; // first and number of hyperplanes
+	ptrdiff_t j; // counter
+	minfft_cmpl *x=s->x,*t=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		mkcx(x+(n0+j)*N1,u+j,BLK,s->a->sub1,w,s->cx);
+	tile_cx(u,1,BLK,t+n0,1,N2,b,N1);
+}
+
+// strided complex transforms of a block of contiguous rows
+static void
+cx_row (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N1-n0<BLK?N1-n0:BLK; // first and number of rows
+	ptrdiff_t j; // counter
+	minfft_cmpl *t=s->x,*y=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		(*s->cx)(t+(n0+j)*N2,u+j,BLK,s->a->sub2,w);
+	tile_cx(u,1,BLK,y+s->sy*n0,s->sy,s->sy*N1,b,N2);
+}
 
 // make a strided any-dimensional complex transform
 // by repeated application of its strided one-dimensional routine
 inline static void
-mkcx (minfft_cmpl *x, minfft_cmpl *y, int sy, const minfft_aux *a, s_cx_1d_t s_1d) {
-	if (a->sub2==NULL)
-		(*s_1d)(x,y,sy,a);
+mkcx (minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws, s_cx_1d_t s_1d) {
+	if (a->sub2==NULL || a->alg==ALG_BAILEY)
+		(*s_1d)(x,y,sy,a,ws);
 	else {
-		int N1=a->sub1->N,N2=a->sub2->N; // transform lengths
-		int n; // counter
-		minfft_cmpl *t=a->t; // temporary buffer
+		minfft_cmpl *t=ws; // temporary buffer
+		struct stage s=make_stage(a,ws);
+		s.cx=s_1d;
 		// strided transform of contiguous hyperplanes
-		for (n=0; n<N2; ++n)
-			mkcx(x+n*N1,t+n,N2,a->sub1,s_1d);
+		s.sub=cx_plane;
+		s.x=x;
+		s.y=t;
+		run_stage(&s,a->sub2->N);
 		// strided transform of contiguous rows
-		for (n=0; n<N1; ++n)
-			(*s_1d)(t+n*N2,y+sy*n,sy*N1,a->sub2);
+		s.sub=cx_row;
+		s.x=t;
+		s.y=y;
+		s.sy=sy;
+		run_stage(&s,a->sub1->N);
 	}
 }
 
-// a pointer to a strided 1d real transform routine
-typedef
-void (*s_rx_1d_t)
-(minfft_real*,minfft_real*,int,const minfft_aux*);
+// strided real transforms of a block of contiguous hyperplanes
+static void
+rx_plane (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N2-n0<BLK?N2-n0:BLK; // first and number of hyperplanes
+	ptrdiff_t j; // counter
+	minfft_real *x=s->x,*t=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		mkrx(x+(n0+j)*N1,u+j,BLK,s->a->sub1,w,s->rx);
+	tile_rx(u,1,BLK,t+n0,1,N2,b,N1);
+}
+
+// strided real transforms of a block of contiguous rows
+static void
+rx_row (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N1-n0<BLK?N1-n0:BLK; // first and number of rows
+	ptrdiff_t j; // counter
+	minfft_real *t=s->x,*y=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		(*s->rx)(t+(n0+j)*N2,u+j,BLK,s->a->sub2,w);
+	tile_rx(u,1,BLK,y+s->sy*n0,s->sy,s->sy*N1,b,N2);
+}
 
 // make a strided any-dimensional real transform
 // by repeated application of its strided one-dimensional routine
 inline static void
-mkrx (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a, s_rx_1d_t s_1d) {
+mkrx (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws, s_rx_1d_t s_1d) {
 	if (a->sub2==NULL)
-		(*s_1d)(x,y,sy,a);
+		(*s_1d)(x,y,sy,a,ws);
 	else {
-		int N1=a->sub1->N,N2=a->sub2->N; // transform lengths
-		int n; // counter
-		minfft_real *t=a->t; // temporary buffer
+		minfft_real *t=ws; // temporary buffer
+		struct stage s=make_stage(a,ws);
+		s.rx=s_1d;
 		// strided transform of contiguous hyperplanes
-		for (n=0; n<N2; ++n)
-			mkrx(x+n*N1,t+n,N2,a->sub1,s_1d);
+		s.sub=rx_plane;
+		s.x=x;
+		s.y=t;
+		run_stage(&s,a->sub2->N);
 		// strided transform of contiguous rows
-		for (n=0; n<N1; ++n)
-			(*s_1d)(t+n*N2,y+sy*n,sy*N1,a->sub2);
+		s.sub=rx_row;
+		s.x=t;
+		s.y=y;
+		s.sy=sy;
+		run_stage(&s,a->sub1->N);
 	}
 }
 
 // *** complex transforms ***
 
-// recursive strided one-dimensional DFT
-inline static void
-rs_dft_1d (int N, minfft_cmpl *x, minfft_cmpl *t, minfft_cmpl *y, int sy, const minfft_cmpl *e) {
-	int n; // counter
-	// split-radix DIF
-	if (N==1) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		// y[0]=x[0];
-		yr[0]=xr[0];
-		yi[0]=xi[0];
-		return;
-	}
-	if (N==2) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r;
-		register minfft_real t0i,t1i;
-		// t0=x[0]+x[1];
-		t0r=xr[0]+xr[2];
-		t0i=xi[0]+xi[2];
-		// t1=x[0]-x[1];
-		t1r=xr[0]-xr[2];
-		t1i=xi[0]-xi[2];
-		// y[0]=t0;
-		yr[0]=t0r;
-		yi[0]=t0i;
-		// y[sy]=t1;
-		yr[2*sy]=t1r;
-		yi[2*sy]=t1i;
-		return;
-	}
-	if (N==4) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		// t0=x[0]+x[2];
-		t0r=xr[0]+xr[4];
-		t0i=xi[0]+xi[4];
-		// t1=x[1]+x[3];
-		t1r=xr[2]+xr[6];
-		t1i=xi[2]+xi[6];
-		// t2=x[0]-x[2];
-		t2r=xr[0]-xr[4];
-		t2i=xi[0]-xi[4];
-		// t3=I*(x[1]-x[3]);
-		t3r=-xi[2]+xi[6];
-		t3i=xr[2]-xr[6];
-		// y[0]=t0+t1;
-		yr[0]=t0r+t1r;
-		yi[0]=t0i+t1i;
-		// y[sy]=t2-t3;
-		yr[2*sy]=t2r-t3r;
-		yi[2*sy]=t2i-t3i;
-		// y[2*sy]=t0-t1;
-		yr[4*sy]=t0r-t1r;
-		yi[4*sy]=t0i-t1i;
-		// y[3*sy]=t2+t3;
-		yr[6*sy]=t2r+t3r;
-		yi[6*sy]=t2i+t3i;
-		return;
-	}
-	if (N==8) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		register minfft_real t00r,t01r,t02r,t03r;
-		register minfft_real t00i,t01i,t02i,t03i;
-		register minfft_real t10r,t11r,t12r,t13r;
-		register minfft_real t10i,t11i,t12i,t13i;
-		register minfft_real ttr,tti;
-		// t0=x[0]+x[4];
-		t0r=xr[0]+xr[8];
-		t0i=xi[0]+xi[8];
-		// t1=x[2]+x[6];
-		t1r=xr[4]+xr[12];
-		t1i=xi[4]+xi[12];
-		// t2=x[0]-x[4];
-		t2r=xr[0]-xr[8];
-		t2i=xi[0]-xi[8];
-		// t3=I*(x[2]-x[6]);
-		t3r=-xi[4]+xi[12];
-		t3i=xr[4]-xr[12];
-		// t00=t0+t1;
-		t00r=t0r+t1r;
-		t00i=t0i+t1i;
-		// t01=t2-t3;
-		t01r=t2r-t3r;
-		t01i=t2i-t3i;
-		// t02=t0-t1;
-		t02r=t0r-t1r;
-		t02i=t0i-t1i;
-		// t03=t2+t3;
-		t03r=t2r+t3r;
-		t03i=t2i+t3i;
-		// t0=x[1]+x[5];
-		t0r=xr[2]+xr[10];
-		t0i=xi[2]+xi[10];
-		// t1=x[3]+x[7];
-		t1r=xr[6]+xr[14];
-		t1i=xi[6]+xi[14];
-		// t2=x[1]-x[5];
-		t2r=xr[2]-xr[10];
-		t2i=xi[2]-xi[10];
-		// t3=I*(x[3]-x[7]);
-		t3r=-xi[6]+xi[14];
-		t3i=xr[6]-xr[14];
-		// t10=t0+t1;
-		t10r=t0r+t1r;
-		t10i=t0i+t1i;
-		// t11=(t2-t3)*invsqrt2*(1-I);
-		ttr=t2r-t3r;
-		tti=t2i-t3i;
-		t11r=invsqrt2*(ttr+tti);
-		t11i=invsqrt2*(tti-ttr);
-		// t12=(t0-t1)*(-I);
-		t12r=t0i-t1i;
-		t12i=-t0r+t1r;
-		// t13=(t2+t3)*invsqrt2*(-1-I);
-		ttr=t2r+t3r;
-		tti=t2i+t3i;
-		t13r=invsqrt2*(tti-ttr);
-		t13i=-invsqrt2*(tti+ttr);
-		// y[0]=t00+t10;
-		yr[0]=t00r+t10r;
-		yi[0]=t00i+t10i;
-		// y[sy]=t01+t11;
-		yr[2*sy]=t01r+t11r;
-		yi[2*sy]=t01i+t11i;
-		// y[2*sy]=t02+t12;
-		yr[4*sy]=t02r+t12r;
-		yi[4*sy]=t02i+t12i;
-		// y[3*sy]=t03+t13;
-		yr[6*sy]=t03r+t13r;
-		yi[6*sy]=t03i+t13i;
-		// y[4*sy]=t00-t10;
-		yr[8*sy]=t00r-t10r;
-		yi[8*sy]=t00i-t10i;
-		// y[5*sy]=t01-t11;
-		yr[10*sy]=t01r-t11r;
-		yi[10*sy]=t01i-t11i;
-		// y[6*sy]=t02-t12;
-		yr[12*sy]=t02r-t12r;
-		yi[12*sy]=t02i-t12i;
-		// y[7*sy]=t03-t13;
-		yr[14*sy]=t03r-t13r;
-		yi[14*sy]=t03i-t13i;
-		return;
-	}
-	// recursion
-	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *xi=xr+1,*ti=tr+1,*ei=er+1;
-	// prepare sub-transform inputs
-	for (n=0; n<N/4; ++n) {
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		// t0=x[n]+x[n+N/2];
-		t0r=xr[2*n]+xr[2*n+N];
-		t0i=xi[2*n]+xi[2*n+N];
-		// t1=x[n+N/4]+x[n+3*N/4];
-		t1r=xr[2*n+N/2]+xr[2*n+3*N/2];
-		t1i=xi[2*n+N/2]+xi[2*n+3*N/2];
-		// t2=x[n]-x[n+N/2];
-		t2r=xr[2*n]-xr[2*n+N];
-		t2i=xi[2*n]-xi[2*n+N];
-		// t3=I*(x[n+N/4]-x[n+3*N/4]);
-		t3r=-xi[2*n+N/2]+xi[2*n+3*N/2];
-		t3i=xr[2*n+N/2]-xr[2*n+3*N/2];
-		// t[n]=t0;
-		tr[2*n]=t0r;
-		ti[2*n]=t0i;
-		// t[n+N/4]=t1;
-		tr[2*n+N/2]=t1r;
-		ti[2*n+N/2]=t1i;
-		// t[n+N/2]=(t2-t3)*e[2*n];
-		t0r=t2r-t3r;
-		t0i=t2i-t3i;
-		t1r=t2r+t3r;
-		t1i=t2i+t3i;
-		tr[2*n+N]=t0r*er[4*n]-t0i*ei[4*n];
-		ti[2*n+N]=t0r*ei[4*n]+t0i*er[4*n];
-		// t[n+3*N/4]=(t2+t3)*e[2*n+1];
-		tr[2*n+3*N/2]=t1r*er[4*n+2]-t1i*ei[4*n+2];
-		ti[2*n+3*N/2]=t1r*ei[4*n+2]+t1i*er[4*n+2];
-	}
-	// call sub-transforms
-	rs_dft_1d(N/2,t,t,y,2*sy,e+N/2);
-	rs_dft_1d(N/4,t+N/2,t+N/2,y+sy,4*sy,e+3*N/4);
-	rs_dft_1d(N/4,t+3*N/4,t+3*N/4,y+3*sy,4*sy,e+3*N/4);
-}
-
-// strided one-dimensional DFT
-inline static void
-s_dft_1d (minfft_cmpl *x, minfft_cmpl *y, int sy, const minfft_aux *a) {
-	rs_dft_1d(a->N,x,a->t,y,sy,a->e);
-}
-
 // strided DFT of arbitrary dimension
 inline static void
-s_dft (minfft_cmpl *x, minfft_cmpl *y, int sy, const minfft_aux *a) {
-	mkcx(x,y,sy,a,s_dft_1d);
+s_dft (minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkcx(x,y,sy,a,ws,a->k->dft);
 }
 
 // user interface
 void
 minfft_dft (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a) {
-	s_dft(x,y,1,a);
-}
-
-// recursive strided one-dimensional inverse DFT
-inline static void
-rs_invdft_1d (int N, minfft_cmpl *x, minfft_cmpl *t, minfft_cmpl *y, int sy, const minfft_cmpl *e) {
-	int n; // counter
-	// split-radix DIF
-	if (N==1) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		// y[0]=x[0];
-		yr[0]=xr[0];
-		yi[0]=xi[0];
-		return;
-	}
-	if (N==2) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r;
-		register minfft_real t0i,t1i;
-		// t0=x[0]+x[1];
-		t0r=xr[0]+xr[2];
-		t0i=xi[0]+xi[2];
-		// t1=x[0]-x[1];
-		t1r=xr[0]-xr[2];
-		t1i=xi[0]-xi[2];
-		// y[0]=t0;
-		yr[0]=t0r;
-		yi[0]=t0i;
-		// y[sy]=t1;
-		yr[2*sy]=t1r;
-		yi[2*sy]=t1i;
-		return;
-	}
-	if (N==4) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		// t0=x[0]+x[2];
-		t0r=xr[0]+xr[4];
-		t0i=xi[0]+xi[4];
-		// t1=x[1]+x[3];
-		t1r=xr[2]+xr[6];
-		t1i=xi[2]+xi[6];
-		// t2=x[0]-x[2];
-		t2r=xr[0]-xr[4];
-		t2i=xi[0]-xi[4];
-		// t3=I*(x[1]-x[3]);
-		t3r=-xi[2]+xi[6];
-		t3i=xr[2]-xr[6];
-		// y[0]=t0+t1;
-		yr[0]=t0r+t1r;
-		yi[0]=t0i+t1i;
-		// y[sy]=t2+t3;
-		yr[2*sy]=t2r+t3r;
-		yi[2*sy]=t2i+t3i;
-		// y[2*sy]=t0-t1;
-		yr[4*sy]=t0r-t1r;
-		yi[4*sy]=t0i-t1i;
-		// y[3*sy]=t2-t3;
-		yr[6*sy]=t2r-t3r;
-		yi[6*sy]=t2i-t3i;
-		return;
-	}
-	if (N==8) {
-		// terminal case
-		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
-		minfft_real *xi=xr+1,*yi=yr+1;
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		register minfft_real t00r,t01r,t02r,t03r;
-		register minfft_real t00i,t01i,t02i,t03i;
-		register minfft_real t10r,t11r,t12r,t13r;
-		register minfft_real t10i,t11i,t12i,t13i;
-		register minfft_real ttr,tti;
-		// t0=x[0]+x[4];
-		t0r=xr[0]+xr[8];
-		t0i=xi[0]+xi[8];
-		// t1=x[2]+x[6];
-		t1r=xr[4]+xr[12];
-		t1i=xi[4]+xi[12];
-		// t2=x[0]-x[4];
-		t2r=xr[0]-xr[8];
-		t2i=xi[0]-xi[8];
-		// t3=I*(x[2]-x[6]);
-		t3r=-xi[4]+xi[12];
-		t3i=xr[4]-xr[12];
-		// t00=t0+t1;
-		t00r=t0r+t1r;
-		t00i=t0i+t1i;
-		// t01=t2+t3;
-		t01r=t2r+t3r;
-		t01i=t2i+t3i;
-		// t02=t0-t1;
-		t02r=t0r-t1r;
-		t02i=t0i-t1i;
-		// t03=t2-t3;
-		t03r=t2r-t3r;
-		t03i=t2i-t3i;
-		// t0=x[1]+x[5];
-		t0r=xr[2]+xr[10];
-		t0i=xi[2]+xi[10];
-		// t1=x[3]+x[7];
-		t1r=xr[6]+xr[14];
-		t1i=xi[6]+xi[14];
-		// t2=x[1]-x[5];
-		t2r=xr[2]-xr[10];
-		t2i=xi[2]-xi[10];
-		// t3=I*(x[3]-x[7]);
-		t3r=-xi[6]+xi[14];
-		t3i=xr[6]-xr[14];
-		// t10=t0+t1;
-		t10r=t0r+t1r;
-		t10i=t0i+t1i;
-		// t11=(t2+t3)*invsqrt2*(1+I);
-		ttr=t2r+t3r;
-		tti=t2i+t3i;
-		t11r=invsqrt2*(ttr-tti);
-		t11i=invsqrt2*(ttr+tti);
-		// t12=(t0-t1)*I;
-		t12r=-t0i+t1i;
-		t12i=t0r-t1r;
-		// t13=(t2-t3)*invsqrt2*(-1+I);
-		ttr=t2r-t3r;
-		tti=t2i-t3i;
-		t13r=-invsqrt2*(ttr+tti);
-		t13i=invsqrt2*(ttr-tti);
-		// y[0]=t00+t10;
-		yr[0]=t00r+t10r;
-		yi[0]=t00i+t10i;
-		// y[sy]=t01+t11;
-		yr[2*sy]=t01r+t11r;
-		yi[2*sy]=t01i+t11i;
-		// y[2*sy]=t02+t12;
-		yr[4*sy]=t02r+t12r;
-		yi[4*sy]=t02i+t12i;
-		// y[3*sy]=t03+t13;
-		yr[6*sy]=t03r+t13r;
-		yi[6*sy]=t03i+t13i;
-		// y[4*sy]=t00-t10;
-		yr[8*sy]=t00r-t10r;
-		yi[8*sy]=t00i-t10i;
-		// y[5*sy]=t01-t11;
-		yr[10*sy]=t01r-t11r;
-		yi[10*sy]=t01i-t11i;
-		// y[6*sy]=t02-t12;
-		yr[12*sy]=t02r-t12r;
-		yi[12*sy]=t02i-t12i;
-		// y[7*sy]=t03-t13;
-		yr[14*sy]=t03r-t13r;
-		yi[14*sy]=t03i-t13i;
-		return;
-	}
-	// recursion
-	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *xi=xr+1,*ti=tr+1,*ei=er+1;
-	// prepare sub-transform inputs
-	for (n=0; n<N/4; ++n) {
-		register minfft_real t0r,t1r,t2r,t3r;
-		register minfft_real t0i,t1i,t2i,t3i;
-		// t0=x[n]+x[n+N/2];
-		t0r=xr[2*n]+xr[2*n+N];
-		t0i=xi[2*n]+xi[2*n+N];
-		// t1=x[n+N/4]+x[n+3*N/4];
-		t1r=xr[2*n+N/2]+xr[2*n+3*N/2];
-		t1i=xi[2*n+N/2]+xi[2*n+3*N/2];
-		// t2=x[n]-x[n+N/2];
-		t2r=xr[2*n]-xr[2*n+N];
-		t2i=xi[2*n]-xi[2*n+N];
-		// t3=I*(x[n+N/4]-x[n+3*N/4]);
-		t3r=-xi[2*n+N/2]+xi[2*n+3*N/2];
-		t3i=xr[2*n+N/2]-xr[2*n+3*N/2];
-		// t[n]=t0;
-		tr[2*n]=t0r;
-		ti[2*n]=t0i;
-		// t[n+N/4]=t1;
-		tr[2*n+N/2]=t1r;
-		ti[2*n+N/2]=t1i;
-		// t[n+N/2]=(t2+t3)*conj(e[2*n]);
-		t0r=t2r+t3r;
-		t0i=t2i+t3i;
-		t1r=t2r-t3r;
-		t1i=t2i-t3i;
-		tr[2*n+N]=t0r*er[4*n]+t0i*ei[4*n];
-		ti[2*n+N]=-t0r*ei[4*n]+t0i*er[4*n];
-		// t[n+3*N/4]=(t2-t3)*conj(e[2*n+1]);
-		tr[2*n+3*N/2]=t1r*er[4*n+2]+t1i*ei[4*n+2];
-		ti[2*n+3*N/2]=-t1r*ei[4*n+2]+t1i*er[4*n+2];
-	}
-	// call sub-transforms
-	rs_invdft_1d(N/2,t,t,y,2*sy,e+N/2);
-	rs_invdft_1d(N/4,t+N/2,t+N/2,y+sy,4*sy,e+3*N/4);
-	rs_invdft_1d(N/4,t+3*N/4,t+3*N/4,y+3*sy,4*sy,e+3*N/4);
+	s_dft(x,y,1,a,a->t);
 }
-
-// strided one-dimensional inverse DFT
-inline static void
-s_invdft_1d (minfft_cmpl *x, minfft_cmpl *y, int sy, const minfft_aux *a) {
-	rs_invdft_1d(a->N,x,a->t,y,sy,a->e);
+void
+minfft_dft_ws (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a, void *ws) {
+	s_dft(x,y,1,a,ws);
 }
 
 // strided inverse DFT of arbitrary dimension
 inline static void
-s_invdft (minfft_cmpl *x, minfft_cmpl *y, int sy, const minfft_aux *a) {
-	mkcx(x,y,sy,a,s_invdft_1d);
+s_invdft (minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkcx(x,y,sy,a,ws,a->k->invdft);
 }
 
 // user interface
 void
 minfft_invdft (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a) {
-	s_invdft(x,y,1,a);
+	s_invdft(x,y,1,a,a->t);
+}
+void
+minfft_invdft_ws (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a, void *ws) {
+	s_invdft(x,y,1,a,ws);
 }
 
 // *** real transforms ***
 
-// strided one-dimensional real DFT
-inline static void
-s_realdft_1d (minfft_real *x, minfft_cmpl *z, int sz, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *e=a->e; // exponent vector
-	minfft_cmpl *w=(minfft_cmpl*)x; // alias
-	minfft_cmpl *t=a->t; // temporary buffer
-	minfft_real *zr=(minfft_real*)z;
-	minfft_real *zi=zr+1;
-	if (N==1) {
-		// trivial case
-		zr[0]=x[0];
-		zi[0]=0;
-		return;
-	}
-	if (N==2) {
-		// trivial case
-		register minfft_real t0,t1;
-		t0=x[0];
-		t1=x[1];
-		// z[0]=t0+t1;
-		zr[0]=t0+t1;
-		zi[0]=0;
-		// z[sz]=t0-t1;
-		zr[2*sz]=t0-t1;
-		zi[2*sz]=0;
-		return;
-	}
-	// reduce to complex DFT of length N/2
-	// do complex DFT
-	s_dft_1d(w,t,1,a->sub1);
-	// recover results
-	register minfft_real ur,vr;
-	register minfft_real ui,vi;
-	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *ti=tr+1,*ei=er+1;
-	// u=t[0];
-	ur=tr[0];
-	ui=ti[0];
-	// z[0]=creal(u)+cimag(u);
-	zr[0]=ur+ui;
-	zi[0]=0;
-	// z[sz*N/2]=creal(u)-cimag(u);
-	zr[sz*N]=ur-ui;
-	zi[sz*N]=0;
-	for (n=1; n<N/4; ++n) {
-		register minfft_real ttr,ter;
-		register minfft_real tti,tei;
-		// u=(t[n]+conj(t[N/2-n]))/2;
-		ur=(tr[2*n]+tr[N-2*n])/2;
-		ui=(ti[2*n]-ti[N-2*n])/2;
-		// v=(t[n]-conj(t[N/2-n]))*e[n]/(2*I);
-		ttr=tr[2*n]-tr[N-2*n];
-		tti=ti[2*n]+ti[N-2*n];
-		ter=ei[2*n]; // te=e[n]/I
-		tei=-er[2*n];
-		vr=(ttr*ter-tti*tei)/2;
-		vi=(ttr*tei+tti*ter)/2;
-		// z[sz*n]=u+v;
-		zr[2*sz*n]=ur+vr;
-		zi[2*sz*n]=ui+vi;
-		// z[sz*(N/2-n)]=conj(u-v);
-		zr[sz*(N-2*n)]=ur-vr;
-		zi[sz*(N-2*n)]=-ui+vi;
-	}
-	// z[sz*N/4]=conj(t[N/4]);
-	zr[sz*N/2]=tr[N/2];
-	zi[sz*N/2]=-ti[N/2];
+// strided real DFTs of a block of contiguous rows
+static void
+realdft_row (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N2-n0<BLK?N2-n0:BLK; // first and number of rows
+	ptrdiff_t j; // counter
+	minfft_real *x=s->x;
+	minfft_cmpl *t=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		(*s->a->k->realdft)(x+(n0+j)*N1,u+j,BLK,s->a->sub1,w);
+	tile_cx(u,1,BLK,t+n0,1,N2,b,N1/2+1);
+}
+
+// strided complex DFTs of a block of contiguous hyperplanes
+static void
+realdft_plane (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N1/2+1-n0<BLK?N1/2+1-n0:BLK; // first and number of hyperplanes
+	ptrdiff_t j; // counter
+	minfft_cmpl *t=s->x,*z=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		s_dft(t+(n0+j)*N2,u+j,BLK,s->a->sub2,w);
+	tile_cx(u,1,BLK,z+n0,1,N1/2+1,b,N2);
 }
 
 // real DFT of arbitrary dimension
-void
-minfft_realdft (minfft_real *x, minfft_cmpl *z, const minfft_aux *a) {
+inline static void
+realdft (minfft_real *x, minfft_cmpl *z, const minfft_aux *a, void *ws) {
 	if (a->sub2==NULL)
-		s_realdft_1d(x,z,1,a);
+		(*a->k->realdft)(x,z,1,a,ws);
 	else {
-		int N1=a->sub1->N,N2=a->sub2->N; // transform lengths
-		int n; // counter
-		minfft_cmpl *t=a->t; // temporary buffer
+		ptrdiff_t N1=a->sub1->N,N2=a->sub2->N; // transform lengths
+		minfft_cmpl *t=ws; // temporary buffer
+		struct stage s=make_stage(a,ws);
 		// strided real DFT of contiguous rows
-		for (n=0; n<N2; ++n)
-			s_realdft_1d(x+n*N1,t+n,N2,a->sub1);
+		s.sub=realdft_row;
+		s.x=x;
+		s.y=t;
+		run_stage(&s,N2);
 		// strided complex DFT of contiguous hyperplanes
-		for (n=0; n<N1/2+1; ++n)
-			s_dft(t+n*N2,z+n,N1/2+1,a->sub2);
+		s.sub=realdft_plane;
+		s.x=t;
+		s.y=z;
+		run_stage(&s,N1/2+1);
 	}
 }
 
-// one-dimensional inverse real DFT
-inline static void
-invrealdft_1d (minfft_cmpl *z, minfft_real *y, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *e=a->e; // exponent vector
-	minfft_cmpl *w=(minfft_cmpl*)y; // alias
-	minfft_cmpl *t=a->t; // temporary buffer
-	minfft_real *zr=(minfft_real*)z;
-	minfft_real *zi=zr+1;
-	if (N==1) {
-		// trivial case
-		y[0]=zr[0];
-		return;
-	}
-	if (N==2) {
-		// trivial case
-		register minfft_real t0,t1; // temporary values
-		t0=zr[0];
-		t1=zr[2];
-		y[0]=t0+t1;
-		y[1]=t0-t1;
-		return;
-	}
-	// reduce to inverse complex DFT of length N/2
-	// prepare complex DFT inputs
-	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *ti=tr+1,*ei=er+1;
-	// t[0]=(z[0]+z[N/2])+I*(z[0]-z[N/2]);
-	tr[0]=zr[0]+zr[N];
-	ti[0]=zr[0]-zr[N];
-	for (n=1; n<N/4; ++n) {
-		register minfft_real ur,vr;
-		register minfft_real ui,vi;
-		register minfft_real ttr,ter;
-		register minfft_real tti,tei;
-		// u=z[n]+conj(z[N/2-n]);
-		ur=zr[2*n]+zr[N-2*n];
-		ui=zi[2*n]-zi[N-2*n];
-		// v=I*(z[n]-conj(z[N/2-n]))*conj(e[n]);
-		ttr=zr[2*n]-zr[N-2*n];
-		tti=zi[2*n]+zi[N-2*n];
-		ter=ei[2*n]; // te=I*conj(e[n])
-		tei=er[2*n];
-		vr=ttr*ter-tti*tei;
-		vi=ttr*tei+tti*ter;
-		// t[n]=u+v;
-		tr[2*n]=ur+vr;
-		ti[2*n]=ui+vi;
-		// t[N/2-n]=conj(u-v);
-		tr[N-2*n]=ur-vr;
-		ti[N-2*n]=-ui+vi;
-	}
-	// t[N/4]=2*conj(z[N/4]);
-	tr[N/2]=2*zr[N/2];
-	ti[N/2]=-2*zi[N/2];
-	// do inverse complex DFT
-	s_invdft_1d(t,w,1,a->sub1);
+// user interface
+void
+minfft_realdft (minfft_real *x, minfft_cmpl *z, const minfft_aux *a) {
+	realdft(x,z,a,a->t);
+}
+void
+minfft_realdft_ws (minfft_real *x, minfft_cmpl *z, const minfft_aux *a, void *ws) {
+	realdft(x,z,a,ws);
+}
+
+// transpose a block of contiguous rows
+static void
+invrealdft_tr (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N2-n0<BLK?N2-n0:BLK; // first and number of rows
+	minfft_cmpl *z=s->x,*t=s->y;
+	(void)ws;
+	// t[n+N2*k]=z[(N1/2+1)*n+k];
+	tile_cx(z+(N1/2+1)*n0,N1/2+1,1,t+n0,1,N2,b,N1/2+1);
+}
+
+// strided inverse complex DFTs of a block of contiguous hyperplanes
+static void
+invrealdft_plane (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,b=N1/2+1-n0<BLK?N1/2+1-n0:BLK; // first and number of hyperplanes
+	ptrdiff_t j; // counter
+	minfft_cmpl *t=s->x,*z=s->y,*u=ws; // u is the block buffer
+	void *w=(char*)ws+s->bsz; // workspace of subtransforms
+	for (j=0; j<b; ++j)
+		s_invdft(t+(n0+j)*N2,u+j,BLK,s->a->sub2,w);
+	tile_cx(u,1,BLK,z+n0,1,N1/2+1,b,N2);
+}
+
+// inverse real DFTs of a block of contiguous rows
+static void
+invrealdft_row (const struct stage *s, ptrdiff_t n, void *ws) {
+	ptrdiff_t N1=s->a->sub1->N,N2=s->a->sub2->N; // transform lengths
+	ptrdiff_t n0=n*BLK,n1=N2-n0<BLK?N2:n0+BLK; // first and last rows
+	minfft_cmpl *z=s->x;
+	minfft_real *y=s->y;
+	for (n=n0; n<n1; ++n)
+		(*s->a->k->invrealdft)(z+n*(N1/2+1),y+n*N1,s->a->sub1,ws);
 }
 
 // inverse real DFT of arbitrary dimension
-void
-minfft_invrealdft (minfft_cmpl *z, minfft_real *y, const minfft_aux *a) {
+inline static void
+invrealdft (minfft_cmpl *z, minfft_real *y, const minfft_aux *a, void *ws) {
 	if (a->sub2==NULL)
-		invrealdft_1d(z,y,a);
+		(*a->k->invrealdft)(z,y,a,ws);
 	else {
-		int N1=a->sub1->N,N2=a->sub2->N; // transform lengths
-		int n; // counter
-		minfft_cmpl *t=a->t; // temporary buffer
-		minfft_real *zr=(minfft_real*)z,*tr=(minfft_real*)t;
-		minfft_real *zi=zr+1,*ti=tr+1;
-		int k;
+		ptrdiff_t N1=a->sub1->N,N2=a->sub2->N; // transform lengths
+		minfft_cmpl *t=ws; // temporary buffer
+		struct stage s=make_stage(a,ws);
 		// transpose
-		for (n=0; n<N2; ++n)
-			for (k=0; k<N1/2+1; ++k) {
-				// t[n+N2*k]=z[(N1/2+1)*n+k];
-				tr[2*n+2*N2*k]=zr[2*(N1/2+1)*n+2*k];
-				ti[2*n+2*N2*k]=zi[2*(N1/2+1)*n+2*k];
-			}
+		s.sub=invrealdft_tr;
+		s.x=z;
+		s.y=t;
+		run_stage(&s,N2);
 		// strided complex DFT of contiguous hyperplanes
-		for (n=0; n<N1/2+1; ++n)
-			s_invdft(t+n*N2,z+n,N1/2+1,a->sub2);
+		s.sub=invrealdft_plane;
+		s.x=t;
+		s.y=z;
+		run_stage(&s,N1/2+1);
 		// inverse real DFT of contiguous rows
-		for (n=0; n<N2; ++n)
-			invrealdft_1d(z+n*(N1/2+1),y+n*N1,a->sub1);
+		s.sub=invrealdft_row;
+		s.x=z;
+		s.y=y;
+		run_stage(&s,N2);
 	}
 }
 
-// *** real symmetric transforms ***
-
-// strided one-dimensional DCT-2
-inline static void
-s_dct2_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_real *t=a->t; // temporary buffer
-	minfft_cmpl *z=(minfft_cmpl*)t; // its alias
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=2*x[0];
-		return;
-	}
-	// reduce to real DFT of length N
-	// prepare sub-transform inputs
-	for (n=0; n<N/2; ++n) {
-		t[n]=x[2*n];
-		t[N/2+n]=x[N-1-2*n];
-	}
-        // do real DFT in-place
-	s_realdft_1d(t,z,1,a->sub1);
-	// recover results
-	minfft_real *er=(minfft_real*)e;
-	minfft_real *ei=er+1;
-	// y[0]=2*creal(z[0]);
-	y[0]=2*t[0];
-	for (n=1; n<N/2; ++n) {
-		// y[sy*n]=2*creal(z[n]*e[n]);
-		y[sy*n]=2*(t[2*n]*er[2*n]-t[2*n+1]*ei[2*n]);
-		// y[sy*(N-n)]=-2*cimag(z[n]*e[n]);
-		y[sy*(N-n)]=-2*(t[2*n]*ei[2*n]+t[2*n+1]*er[2*n]);
-	}
-	// y[sy*N/2]=sqrt2*creal(z[N/2]);
-	y[sy*N/2]=sqrt2*t[N];
+// user interface
+void
+minfft_invrealdft (minfft_cmpl *z, minfft_real *y, const minfft_aux *a) {
+	invrealdft(z,y,a,a->t);
+}
+void
+minfft_invrealdft_ws (minfft_cmpl *z, minfft_real *y, const minfft_aux *a, void *ws) {
+	invrealdft(z,y,a,ws);
 }
 
+// *** real symmetric transforms ***
+
 // strided DCT-2 of arbitrary dimension
 inline static void
-s_dct2 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dct2_1d);
+s_dct2 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dct2);
 }
 
 // user interface
 void
 minfft_dct2 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dct2(x,y,1,a);
+	s_dct2(x,y,1,a,a->t);
 }
-
-// strided one-dimensional DST-2
-inline static void
-s_dst2_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_real *t=a->t; // temporary buffer
-	minfft_cmpl *z=(minfft_cmpl*)t; // its alias
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=2*x[0];
-		return;
-	}
-	// reduce to real DFT of length N
-	// prepare sub-transform inputs
-	for (n=0; n<N/2; ++n) {
-		t[n]=x[2*n];
-		t[N/2+n]=-x[N-1-2*n];
-	}
-        // do real DFT in-place
-	s_realdft_1d(t,z,1,a->sub1);
-	// recover results
-	minfft_real *er=(minfft_real*)e;
-	minfft_real *ei=er+1;
-	// y[sy*(N-1)]=2*creal(z[0]);
-	y[sy*(N-1)]=2*t[0];
-	for (n=1; n<N/2; ++n) {
-		// y[sy*(n-1)]=-2*cimag(z[n]*e[n]);
-		y[sy*(n-1)]=-2*(t[2*n]*ei[2*n]+t[2*n+1]*er[2*n]);
-		// y[sy*(N-n-1)]=2*creal(z[n]*e[n]);
-		y[sy*(N-n-1)]=2*(t[2*n]*er[2*n]-t[2*n+1]*ei[2*n]);
-	}
-	// y[sy*(N/2-1)]=sqrt2*creal(z[N/2]);
-	y[sy*(N/2-1)]=sqrt2*t[N];
+void
+minfft_dct2_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dct2(x,y,1,a,ws);
 }
 
 // strided DST-2 of arbitrary dimension
 inline static void
-s_dst2 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dst2_1d);
+s_dst2 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dst2);
 }
 
 // user interface
 void
 minfft_dst2 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dst2(x,y,1,a);
+	s_dst2(x,y,1,a,a->t);
 }
-
-// strided one-dimensional DCT-3
-inline static void
-s_dct3_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *z=a->t; // temporary buffer
-	minfft_real *t=(minfft_real*)z; // its alias
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=x[0];
-		return;
-	}
-	// reduce to inverse real DFT of length N
-	// prepare sub-transform inputs
-	minfft_real *er=(minfft_real*)e,*zr=(minfft_real*)z;
-	minfft_real *ei=er+1,*zi=zr+1;
-	// z[0]=x[0];
-	zr[0]=x[0];
-	zi[0]=0;
-	for (n=1; n<N/2; ++n) {
-		// z[n]=conj((x[n]+I*x[N-n])*e[n]);
-		zr[2*n]=x[n]*er[2*n]-x[N-n]*ei[2*n];
-		zi[2*n]=-x[n]*ei[2*n]-x[N-n]*er[2*n];
-	}
-	// z[N/2]=sqrt2*x[N/2];
-	zr[N]=sqrt2*x[N/2];
-	zi[N]=0;
-	// do inverse real DFT in-place
-	invrealdft_1d(z,t,a->sub1);
-	// recover results
-	for (n=0; n<N/2; ++n) {
-		y[sy*2*n]=t[n];
-		y[sy*(N-1-2*n)]=t[N/2+n];
-	}
+void
+minfft_dst2_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dst2(x,y,1,a,ws);
 }
 
 // strided DCT-3 of arbitrary dimension
 inline static void
-s_dct3 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dct3_1d);
+s_dct3 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dct3);
 }
 
 // user interface
 void
 minfft_dct3 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dct3(x,y,1,a);
+	s_dct3(x,y,1,a,a->t);
 }
-
-// strided one-dimensional DST-3
-inline static void
-s_dst3_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *z=a->t; // temporary buffer
-	minfft_real *t=(minfft_real*)z; // its alias
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=x[0];
-		return;
-	}
-	// reduce to inverse real DFT of length N
-	// prepare sub-transform inputs
-	minfft_real *er=(minfft_real*)e,*zr=(minfft_real*)z;
-	minfft_real *ei=er+1,*zi=zr+1;
-	// z[0]=x[N-1];
-	zr[0]=x[N-1];
-	zi[0]=0;
-	for (n=1; n<N/2; ++n) {
-		// z[n]=conj((x[N-n-1]+I*x[n-1])*e[n]);
-		zr[2*n]=x[N-n-1]*er[2*n]-x[n-1]*ei[2*n];
-		zi[2*n]=-x[N-n-1]*ei[2*n]-x[n-1]*er[2*n];
-	}
-	// z[N/2]=sqrt2*x[N/2-1];
-	zr[N]=sqrt2*x[N/2-1];
-	zi[N]=0;
-	// do inverse real DFT in-place
-	invrealdft_1d(z,t,a->sub1);
-	// recover results
-	for (n=0; n<N/2; ++n) {
-		y[sy*2*n]=t[n];
-		y[sy*(N-1-2*n)]=-t[N/2+n];
-	}
+void
+minfft_dct3_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dct3(x,y,1,a,ws);
 }
 
 // strided DST-3 of arbitrary dimension
 inline static void
-s_dst3 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dst3_1d);
+s_dst3 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dst3);
 }
 
 // user interface
 void
 minfft_dst3 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dst3(x,y,1,a);
+	s_dst3(x,y,1,a,a->t);
 }
-
-// strided one-dimensional DCT-4
-inline static void
-s_dct4_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *t=a->t; // temporary buffer
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=sqrt2*x[0];
-		return;
-	}
-	// reduce to complex DFT of length N/2
-	// prepare sub-transform inputs
-	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *ti=tr+1,*ei=er+1;
-	for (n=0; n<N/2; ++n) {
-		// t[n]=*e++*(x[2*n]+I*x[N-1-2*n]);
-		tr[2*n]=er[2*n]*x[2*n]-ei[2*n]*x[N-1-2*n];
-		ti[2*n]=er[2*n]*x[N-1-2*n]+ei[2*n]*x[2*n];
-	}
-	// do complex DFT in-place
-	s_dft_1d(t,t,1,a->sub1);
-	// recover results
-	er+=N;
-	ei+=N;
-	for (n=0; n<N/2; ++n) {
-		// y[sy*2*n]=2*creal(*e++*t[n]);
-		y[sy*2*n]=2*(er[4*n]*tr[2*n]-ei[4*n]*ti[2*n]);
-		// y[sy*(2*n+1)]=2*creal(*e++*conj(t[N/2-1-n]));
-		y[sy*(2*n+1)]=2*(er[4*n+2]*tr[N-2-2*n]+ei[4*n+2]*ti[N-2-2*n]);
-	}
+void
+minfft_dst3_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dst3(x,y,1,a,ws);
 }
 
 // strided DCT-4 of arbitrary dimension
 inline static void
-s_dct4 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dct4_1d);
+s_dct4 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dct4);
 }
 
 // user interface
 void
 minfft_dct4 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dct4(x,y,1,a);
+	s_dct4(x,y,1,a,a->t);
+}
+void
+minfft_dct4_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dct4(x,y,1,a,ws);
 }
 
-// strided one-dimensional DST-4
+// strided DST-4 of arbitrary dimension
 inline static void
-s_dst4_1d (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	int n; // counter
-	int N=a->N; // transform length
-	minfft_cmpl *t=a->t; // temporary buffer
-	minfft_cmpl *e=a->e; // exponent vector
-	if (N==1) {
-		// trivial case
-		y[0]=sqrt2*x[0];
-		return;
+s_dst4 (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	mkrx(x,y,sy,a,ws,a->k->dst4);
+}
+
+// user interface
+void
+minfft_dst4 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
+	s_dst4(x,y,1,a,a->t);
+}
+void
+minfft_dst4_ws (minfft_real *x, minfft_real *y, const minfft_aux *a, void *ws) {
+	s_dst4(x,y,1,a,ws);
+}
+
+// *** batches of one-dimensional transforms ***
+
+// gather N complex numbers with stride sx
+inline static void
+gather_cx (minfft_cmpl *x, ptrdiff_t sx, minfft_cmpl *t, ptrdiff_t N) {
+	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t;
+	minfft_real *xi=xr+1,*ti=tr+1;
+	ptrdiff_t n; // counter
+	for (n=0; n<N; ++n) {
+		// t[n]=x[sx*n];
+		tr[2*n]=xr[2*sx*n];
+		ti[2*n]=xi[2*sx*n];
+	}
+}
+
+// complex DFTs of the n-th block of a batch
+static void
+dft_many_sub (const struct stage *s, ptrdiff_t n, void *ws) {
+	const minfft_aux *a=s->a,*l=a->sub1; // batch and line aux data
+	ptrdiff_t i,i1=a->N/l->N-n*BLK<BLK?a->N/l->N:n*BLK+BLK; // counter and its end
+	minfft_cmpl *x,*y;
+	for (i=n*BLK; i<i1; ++i) {
+		x=(minfft_cmpl*)s->x+a->dx*i;
+		y=(minfft_cmpl*)s->y+a->dy*i;
+		if (a->sx!=1) {
+			// gather the input into the line buffer
+			gather_cx(x,a->sx,ws,l->N);
+			x=ws;
+		}
+		(*s->cx)(x,y,a->sy,l->sub1,sub_ws(ws,l));
 	}
-	// reduce to complex DFT of length N/2
-	// prepare sub-transform inputs
-	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
-	minfft_real *ti=tr+1,*ei=er+1;
-	for (n=0; n<N/2; ++n) {
-		// t[n]=-*e++*(x[2*n]-I*x[N-1-2*n]);
-		tr[2*n]=-er[2*n]*x[2*n]-ei[2*n]*x[N-1-2*n];
-		ti[2*n]=er[2*n]*x[N-1-2*n]-ei[2*n]*x[2*n];
+}
+
+// batch of complex DFTs
+inline static void
+dft_many (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a, void *ws, s_cx_1d_t s_1d) {
+	struct stage s=make_stage(a,ws);
+	s.sub=dft_many_sub;
+	s.cx=s_1d;
+	s.x=x;
+	s.y=y;
+	run_stage(&s,a->N/a->sub1->N);
+}
+
+// user interface
+void
+minfft_dft_many (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a) {
+	dft_many(x,y,a,a->t,a->k->dft);
+}
+void
+minfft_dft_many_ws (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a, void *ws) {
+	dft_many(x,y,a,ws,a->k->dft);
+}
+void
+minfft_invdft_many (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a) {
+	dft_many(x,y,a,a->t,a->k->invdft);
+}
+void
+minfft_invdft_many_ws (minfft_cmpl *x, minfft_cmpl *y, const minfft_aux *a, void *ws) {
+	dft_many(x,y,a,ws,a->k->invdft);
+}
+
+// real DFTs of the n-th block of a batch
+static void
+realdft_many_sub (const struct stage *s, ptrdiff_t n, void *ws) {
+	const minfft_aux *a=s->a,*l=a->sub1; // batch and line aux data
+	ptrdiff_t i,i1=a->N/l->N-n*BLK<BLK?a->N/l->N:n*BLK+BLK; // counter and its end
+	minfft_real *x,*t=ws; // t is the line buffer
+	minfft_cmpl *z;
+	ptrdiff_t k; // counter
+	for (i=n*BLK; i<i1; ++i) {
+		x=(minfft_real*)s->x+a->dx*i;
+		z=(minfft_cmpl*)s->y+a->dy*i;
+		if (a->sx!=1) {
+			// gather the input into the line buffer
+			for (k=0; k<l->N; ++k)
+				t[k]=x[a->sx*k];
+			x=t;
+		}
+		(*a->k->realdft)(x,z,a->sy,l->sub1,sub_ws(ws,l));
 	}
-	// do complex DFT in-place
-	s_dft_1d(t,t,1,a->sub1);
-	// recover results
-	er+=N;
-	ei+=N;
-	for (n=0; n<N/2; ++n) {
-		// y[sy*2*n]=2*cimag(*e++*t[n]);
-		y[sy*2*n]=2*(er[4*n]*ti[2*n]+ei[4*n]*tr[2*n]);
-		// y[sy*(2*n+1)]=2*cimag(*e++*conj(t[N/2-1-n]));
-		y[sy*(2*n+1)]=2*(-er[4*n+2]*ti[N-2-2*n]+ei[4*n+2]*tr[N-2-2*n]);
+}
+
+// batch of real DFTs
+inline static void
+realdft_many (minfft_real *x, minfft_cmpl *z, const minfft_aux *a, void *ws) {
+	struct stage s=make_stage(a,ws);
+	s.sub=realdft_many_sub;
+	s.x=x;
+	s.y=z;
+	run_stage(&s,a->N/a->sub1->N);
+}
+
+// user interface
+void
+minfft_realdft_many (minfft_real *x, minfft_cmpl *z, const minfft_aux *a) {
+	realdft_many(x,z,a,a->t);
+}
+void
+minfft_realdft_many_ws (minfft_real *x, minfft_cmpl *z, const minfft_aux *a, void *ws) {
+	realdft_many(x,z,a,ws);
+}
+
+// inverse real DFTs of the n-th block of a batch
+static void
+invrealdft_many_sub (const struct stage *s, ptrdiff_t n, void *ws) {
+	const minfft_aux *a=s->a,*l=a->sub1; // batch and line aux data
+	ptrdiff_t N=l->N; // transform length
+	ptrdiff_t i,i1=a->N/N-n*BLK<BLK?a->N/N:n*BLK+BLK; // counter and its end
+	minfft_cmpl *z,*t=ws; // t is the input line buffer
+	minfft_real *y,*u=(minfft_real*)((char*)ws+ws_part((N/2+1)*sizeof(minfft_cmpl))); // output line buffer
+	ptrdiff_t k; // counter
+	for (i=n*BLK; i<i1; ++i) {
+		z=(minfft_cmpl*)s->x+a->dy*i;
+		y=(minfft_real*)s->y+a->dx*i;
+		if (a->sy!=1) {
+			// gather the input into the line buffer
+			gather_cx(z,a->sy,t,N/2+1);
+			z=t;
+		}
+		if (a->sx==1)
+			(*a->k->invrealdft)(z,y,l->sub1,sub_ws(ws,l));
+		else {
+			// scatter the output from the line buffer
+			(*a->k->invrealdft)(z,u,l->sub1,sub_ws(ws,l));
+			for (k=0; k<N; ++k)
+				y[a->sx*k]=u[k];
+		}
 	}
 }
 
-// strided DST-4 of arbitrary dimension
+// batch of inverse real DFTs
 inline static void
-s_dst4 (minfft_real *x, minfft_real *y, int sy, const minfft_aux *a) {
-	mkrx(x,y,sy,a,s_dst4_1d);
+invrealdft_many (minfft_cmpl *z, minfft_real *y, const minfft_aux *a, void *ws) {
+	struct stage s=make_stage(a,ws);
+	s.sub=invrealdft_many_sub;
+	s.x=z;
+	s.y=y;
+	run_stage(&s,a->N/a->sub1->N);
 }
 
 // user interface
 void
-minfft_dst4 (minfft_real *x, minfft_real *y, const minfft_aux *a) {
-	s_dst4(x,y,1,a);
+minfft_invrealdft_many (minfft_cmpl *z, minfft_real *y, const minfft_aux *a) {
+	invrealdft_many(z,y,a,a->t);
+}
+void
+minfft_invrealdft_many_ws (minfft_cmpl *z, minfft_real *y, const minfft_aux *a, void *ws) {
+	invrealdft_many(z,y,a,ws);
 }
 
 // *** making of aux data ***
 
+// length from which the complex DFT is done by the four-step algorithm
+#ifndef BAILEY_MIN
+#define BAILEY_MIN (1<<22)
+#endif
+
+static const minfft_real pi=3.141592653589793238462643383279502884L;
+
+#if MINFFT_DISPATCH
+// kernels built for wider instruction sets in separate files
+extern const struct minfft_kernels minfft_kernels_avx;
+extern const struct minfft_kernels minfft_kernels_avx512;
+#endif
+
+// choose the kernels for the running processor
+static const struct minfft_kernels*
+kernels (void) {
+#if MINFFT_DISPATCH && defined(__GNUC__)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		return &minfft_kernels_avx512;
+	if (__builtin_cpu_supports("avx"))
+		return &minfft_kernels_avx;
+#elif MINFFT_DISPATCH && defined(_MSC_VER)
+	int r[4]; // cpuid registers
+	unsigned long long xcr0; // state enabled by the OS
+	__cpuid(r,1);
+	// AVX and OSXSAVE
+	if ((r[2]&0x18000000)==0x18000000) {
+		xcr0=_xgetbv(0);
+		__cpuidex(r,7,0);
+		// AVX-512F with opmask and ZMM state enabled
+		if ((r[1]&0x10000) && (xcr0&0xe6)==0xe6)
+			return &minfft_kernels_avx512;
+		// YMM state enabled
+		if ((xcr0&6)==6)
+			return &minfft_kernels_avx;
+	}
+#endif
+	return &minfft_kernels_default;
+}
+
 // routines for computing N-th roots of unity
 
 // prototype
-static minfft_real nsin (int, int);
+static minfft_real nsin (ptrdiff_t, ptrdiff_t);
 
 // cos(2*pi*n/N)
 static minfft_real
-ncos (int n, int N) {
-	// reduce n to 0..N/8
+ncos (ptrdiff_t n, ptrdiff_t N) {
+	// reduce n to 0..N/8, or to 0..N/2 if N is not divisible by 8
 	if (n<0)
 		return ncos(-n,N);
-	else if (n>=N/2)
+	else if (N%8) {
+		n%=N;
+		if (2*n>N)
+			n=N-n;
+	} else if (n>=N/2)
 		return -ncos(n-N/2,N);
 	else if (n>=N/4)
 		return -nsin(n-N/4,N);
 	else if (n>N/8)
 		return nsin(N/4-n,N);
-	else
 #if MINFFT_SINGLE
-		return cosf(2*pi*n/N);
+	return cosf(2*pi*n/N);
 #elif MINFFT_EXTENDED
-		return cosl(2*pi*n/N);
+	return cosl(2*pi*n/N);
 #else
-		return cos(2*pi*n/N);
+	return cos(2*pi*n/N);
 #endif
 }
 
 // sin(2*pi*n/N)
 static minfft_real
-nsin (int n, int N) {
-	// reduce n to 0..N/8
+nsin (ptrdiff_t n, ptrdiff_t N) {
+	// reduce n to 0..N/8, or to 0..N/2 if N is not divisible by 8
 	if (n<0)
 		return -nsin(-n,N);
-	else if (n>=N/2)
+	else if (N%8) {
+		n%=N;
+		if (2*n>N)
+			return -nsin(N-n,N);
+	} else if (n>=N/2)
 		return -nsin(n-N/2,N);
 	else if (n>=N/4)
 		return ncos(n-N/4,N);
 	else if (n>N/8)
 		return ncos(N/4-n,N);
-	else
 #if MINFFT_SINGLE
-		return sinf(2*pi*n/N);
+	return sinf(2*pi*n/N);
 #elif MINFFT_EXTENDED
-		return sinl(2*pi*n/N);
+	return sinl(2*pi*n/N);
 #else
-		return sin(2*pi*n/N);
+	return sin(2*pi*n/N);
 #endif
 }
 
-// make aux data for any transform of arbitrary dimension
-// using its one-dimensional version
-static minfft_aux*
-make_aux (int d, int *Ns, int datasz, minfft_aux* (*aux_1d)(int N)) {
-	minfft_aux *a;
-	int p; // product of all transform lengths
-	int i; // array index
-	if (d==1)
-		return (*aux_1d)(Ns[0]);
-	else {
-		p=1;
-		for (i=0; i<d; ++i)
-			p*=Ns[i];
-		a=malloc(sizeof(minfft_aux));
-		if (a==NULL)
-			goto err;
-		a->N=p;
-		a->t=malloc(p*datasz);
-		if (a->t==NULL)
-			goto err;
-		a->e=NULL;
-		a->sub1=make_aux(d-1,Ns+1,datasz,aux_1d);
-		if (a->sub1==NULL)
-			goto err;
-		a->sub2=(*aux_1d)(Ns[0]);
-		if (a->sub2==NULL)
-			goto err;
-		return a;
-	}
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
+// check if N is a positive product of powers of 2, 3, 5 and 7
+static int
+smooth (ptrdiff_t N) {
+	if (N<=0)
+		return 0;
+	while (N%7==0)
+		N/=7;
+	while (N%5==0)
+		N/=5;
+	while (N%3==0)
+		N/=3;
+	return (N&(N-1))==0;
 }
 
-// make aux data for one-dimensional forward or inverse complex DFT
-minfft_aux*
-minfft_mkaux_dft_1d (int N) {
-	minfft_aux *a;
-	int n;
-	minfft_real *e;
-	if (N<=0 || N&(N-1))
-		// error if N is negative or not a power of two
-		return NULL;
-	a=malloc(sizeof(minfft_aux));
-	if (a==NULL)
-		goto err;
-	a->N=N;
-	if (N>=16) {
-		a->t=malloc(N*sizeof(minfft_cmpl));
-		if (a->t==NULL)
-			goto err;
-		a->e=malloc(N*sizeof(minfft_cmpl));
-		if (a->e==NULL)
-			goto err;
-		e=(minfft_real*)a->e;
-		while (N>=16) {
-			for (n=0; n<N/4; ++n) {
-				*e++=ncos(-n,N);
-				*e++=nsin(-n,N);
-				*e++=ncos(-3*n,N);
-				*e++=nsin(-3*n,N);
+// fill the exponent vector of a complex DFT of length N
+static void
+fill_dft_e (minfft_real *e, ptrdiff_t N) {
+	ptrdiff_t n; // counter
+	int k; // counter
+	int p; // radix
+	// odd radix steps, in the order of rs_dft_1d
+	while (N&(N-1)) {
+		p=N%7==0?7:N%5==0?5:3;
+		for (k=1; k<p; ++k)
+			for (n=0; n<N/p; ++n) {
+				*e++=ncos(-n*k,N);
+				*e++=nsin(-n*k,N);
 			}
-			N/=2;
+		N/=p;
+	}
+	// split-radix steps
+	while (N>=16) {
+		for (n=0; n<N/4; ++n) {
+			*e++=ncos(-n,N);
+			*e++=nsin(-n,N);
+			*e++=ncos(-3*n,N);
+			*e++=nsin(-3*n,N);
 		}
-	} else {
-		a->t=NULL;
-		a->e=NULL;
+		N/=2;
 	}
-	a->sub1=a->sub2=NULL;
-	return a;
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
 }
 
-// make aux data for any-dimensional forward or inverse complex DFT
-minfft_aux*
-minfft_mkaux_dft (int d, int *Ns) {
-	return make_aux(d,Ns,sizeof(minfft_cmpl),minfft_mkaux_dft_1d);
+// allocator hooks for the aux data made from now on (NULL for malloc and free)
+static minfft_alloc *alloc_hook;
+static minfft_dealloc *dealloc_hook;
+static void *alloc_ctx;
+
+// allocate sz bytes aligned to WS_ALIGN, storing the pointer returned
+// by the allocator just before the aligned block
+static void*
+alloc_aligned (minfft_alloc *alloc, void *ctx, size_t sz) {
+	char *p,*q;
+	sz+=sizeof(void*)+WS_ALIGN;
+	p=alloc?(*alloc)(sz,ctx):malloc(sz);
+	if (p==NULL)
+		return NULL;
+	q=p+sizeof(void*);
+	q+=(WS_ALIGN-(uintptr_t)q%WS_ALIGN)%WS_ALIGN;
+	((void**)q)[-1]=p;
+	return q;
 }
 
-// convenience routines for two- and three-dimensional complex DFT
-minfft_aux*
-minfft_mkaux_dft_2d (int N1, int N2) {
-	int Ns[2]={N1,N2};
-	return minfft_mkaux_dft(2,Ns);
+// free memory allocated by alloc_aligned()
+static void
+free_aligned (minfft_dealloc *dealloc, void *ctx, void *q) {
+	void *p;
+	if (q==NULL)
+		return;
+	p=((void**)q)[-1];
+	if (dealloc)
+		(*dealloc)(p,ctx);
+	else
+		free(p);
 }
-minfft_aux*
-minfft_mkaux_dft_3d (int N1, int N2, int N3) {
-	int Ns[3]={N1,N2,N3};
-	return minfft_mkaux_dft(3,Ns);
+
+// allocate and free buffers of aux data by its allocator
+static void*
+mem_alloc (const minfft_aux *a, size_t sz) {
+	return alloc_aligned(a->alloc,a->actx,sz);
+}
+static void
+mem_free (const minfft_aux *a, void *q) {
+	free_aligned(a->dealloc,a->actx,q);
 }
 
-// make aux data for one-dimensional forward or inverse real DFT
+// memory, from which the aux tree is made: a block of the caller,
+// or the heap if p is NULL
+struct arena {
+	char *p; // free part of the block, aligned to WS_ALIGN
+	size_t sz; // its size
+	minfft_aux *nodes; // list of the nodes made, the last one first
+};
+
+// take memory for aux data of a caller's block of len bytes
+static int
+open_arena (struct arena *ar, void *buf, size_t len) {
+	size_t n; // bytes skipped for alignment
+	if (buf==NULL)
+		return -1;
+	n=(WS_ALIGN-(uintptr_t)buf%WS_ALIGN)%WS_ALIGN;
+	if (n>len)
+		return -1;
+	ar->p=(char*)buf+n;
+	ar->sz=len-n;
+	ar->nodes=NULL;
+	return 0;
+}
+
+// allocate sz bytes from an arena
+static void*
+arena_alloc (struct arena *ar, size_t sz) {
+	void *q;
+	if (ar->p==NULL)
+		return alloc_aligned(alloc_hook,alloc_ctx,sz);
+	sz=ws_part(sz);
+	if (sz>ar->sz)
+		return NULL;
+	q=ar->p;
+	ar->p+=sz;
+	ar->sz-=sz;
+	return q;
+}
+
+// free the last sz bytes allocated from an arena
+static void
+arena_free (struct arena *ar, void *q, size_t sz) {
+	if (ar->p==NULL)
+		free_aligned(dealloc_hook,alloc_ctx,q);
+	else {
+		ar->p-=ws_part(sz);
+		ar->sz+=ws_part(sz);
+	}
+}
+
+// free the nodes made in the heap
+static void
+drop_arena (struct arena *ar) {
+	minfft_aux *a,*n; // node and the next one
+	if (ar->p!=NULL)
+		// the caller's block is discarded as a whole
+		return;
+	for (a=ar->nodes; a!=NULL; a=n) {
+		n=a->next;
+		free_aligned(dealloc_hook,alloc_ctx,a->e);
+		free_aligned(dealloc_hook,alloc_ctx,a);
+	}
+	ar->nodes=NULL;
+}
+
+// size of the memory taken by the nodes made in an arena
+static size_t
+arena_size (const struct arena *ar) {
+	const minfft_aux *a;
+	size_t sz=0;
+	for (a=ar->nodes; a!=NULL; a=a->next)
+		sz+=ws_part(sizeof(minfft_aux))+ws_part(a->esz);
+	return sz;
+}
+
+// make an aux structure with no buffers and no subtransforms
+static minfft_aux*
+make_node (struct arena *ar, ptrdiff_t N) {
+	minfft_aux *a;
+	a=arena_alloc(ar,sizeof(minfft_aux));
+	if (a==NULL)
+		return NULL;
+	a->alloc=alloc_hook;
+	a->dealloc=dealloc_hook;
+	a->actx=alloc_ctx;
+	a->N=N;
+	a->alg=ALG_RADIX;
+	a->tsz=0;
+	a->t=NULL;
+	a->esz=0;
+	a->e=NULL;
+	a->sub1=a->sub2=NULL;
+	a->nt=1;
+	a->disp=NULL;
+	a->dctx=NULL;
+	a->k=kernels();
+	a->sx=a->dx=a->sy=a->dy=0;
+	a->kind=0;
+	a->next=ar->nodes;
+	a->copy=NULL;
+	a->mem=a->w=NULL;
+	a->msz=a->wsz=0;
+	a->ce=NULL;
+	ar->nodes=a;
+	return a;
+}
+
+// allocate the exponent vector of sz bytes
+static void*
+alloc_e (struct arena *ar, minfft_aux *a, size_t sz) {
+	a->esz=sz;
+	return arena_alloc(ar,sz);
+}
+
+// kinds of transforms
+#define AUX_DFT 1
+#define AUX_REALDFT 2
+#define AUX_T2T3 3
+#define AUX_T4 4
+#define AUX_DFT_MANY 5
+#define AUX_REALDFT_MANY 6
+
+// one-dimensional transform of a kind already made in an arena,
+// which is shared by all its users
+static minfft_aux*
+find_made (const struct arena *ar, int kind, ptrdiff_t N) {
+	minfft_aux *a;
+	for (a=ar->nodes; a!=NULL; a=a->next)
+		if (a->kind==kind && a->N==N)
+			return a;
+	return NULL;
+}
+
+// mark a one-dimensional transform of a kind for sharing
+static minfft_aux*
+made (minfft_aux *a, int kind) {
+	if (a!=NULL)
+		a->kind=kind;
+	return a;
+}
+
+// copy the nodes made in the heap to a memory block
+static minfft_aux*
+pack_arena (const struct arena *ar, minfft_aux *a, char *p) {
+	minfft_aux *n,*b; // node and its copy
+	for (n=ar->nodes; n!=NULL; n=n->next) {
+		b=n->copy=(minfft_aux*)p;
+		p+=ws_part(sizeof(minfft_aux));
+		*b=*n;
+		if (n->e!=NULL) {
+			b->e=p;
+			memcpy(b->e,n->e,n->esz);
+			p+=ws_part(n->esz);
+		}
+	}
+	// link the copies as the nodes are linked
+	for (n=ar->nodes; n!=NULL; n=n->next) {
+		b=n->copy;
+		b->sub1=n->sub1!=NULL?n->sub1->copy:NULL;
+		b->sub2=n->sub2!=NULL?n->sub2->copy:NULL;
+		b->next=b->copy=NULL;
+	}
+	return a->copy;
+}
+
+// largest number of elements of a transform, for which the sizes
+// of its buffers and the arguments of ncos() and nsin() do not overflow
+#define MAX_N (PTRDIFF_MAX/8/(ptrdiff_t)sizeof(minfft_cmpl))
+
+// prototypes
+static minfft_aux* make_cached (int, int, const ptrdiff_t*);
+static minfft_aux* make_into (int, int, const ptrdiff_t*, void*, size_t);
+
+// product of d transform lengths, or 0 if some length is out of range
+static ptrdiff_t
+product (int d, const ptrdiff_t *Ns) {
+	ptrdiff_t p=1; // product
+	int i; // array index
+	for (i=0; i<d; ++i) {
+		if (Ns[i]<=0 || Ns[i]>MAX_N/p)
+			return 0;
+		p*=Ns[i];
+	}
+	return p;
+}
+
+// make aux data with transform lengths of type int
+static minfft_aux*
+make_aux_int (int d, const int *Ns, minfft_aux* (*make)(int, const ptrdiff_t*)) {
+	minfft_aux *a;
+	ptrdiff_t *Ls; // lengths of type ptrdiff_t
+	int i; // array index
+	if (d<1)
+		return NULL;
+	Ls=malloc(d*sizeof(ptrdiff_t));
+	if (Ls==NULL)
+		return NULL;
+	for (i=0; i<d; ++i)
+		Ls[i]=Ns[i];
+	a=(*make)(d,Ls);
+	free(Ls);
+	return a;
+}
+
+// make aux data for any transform of arbitrary dimension
+// using its one-dimensional version
+static minfft_aux*
+make_aux (struct arena *ar, int d, const ptrdiff_t *Ns, size_t datasz, minfft_aux* (*aux_1d)(struct arena*, ptrdiff_t)) {
+	minfft_aux *a;
+	ptrdiff_t p; // product of all transform lengths
+	if (d<1)
+		return NULL;
+	else if (d==1)
+		return (*aux_1d)(ar,Ns[0]);
+	else {
+		p=product(d,Ns);
+		if (p==0)
+			return NULL;
+		a=make_node(ar,p);
+		if (a==NULL)
+			return NULL;
+		a->tsz=ws_part(p*datasz);
+		a->sub1=make_aux(ar,d-1,Ns+1,datasz,aux_1d);
+		if (a->sub1==NULL)
+			return NULL;
+		a->sub2=(*aux_1d)(ar,Ns[0]);
+		if (a->sub2==NULL)
+			return NULL;
+		return a;
+	}
+}
+
+// prototype
+static minfft_aux* make_aux_dft_1d (struct arena*, ptrdiff_t);
+
+// make aux data for one-dimensional complex DFT by the chirp-z algorithm
+static minfft_aux*
+make_aux_chirp_1d (struct arena *ar, ptrdiff_t N) {
+	minfft_aux *a;
+	ptrdiff_t n,p,m; // counters
+	ptrdiff_t M; // convolution length
+	minfft_real *c,*b; // chirp and its spectrum
+	void *ws; // workspace for computing the spectrum
+	size_t wsz; // its size
+	if (N>MAX_N/4)
+		return NULL;
+	// M is the smallest p*2^k>=2*N-1 for p=1,3,5,7, which are
+	// the fastest among the lengths of comparable size
+	M=PTRDIFF_MAX;
+	for (p=1; p<=7; p+=2) {
+		for (m=p; m<2*N-1; m*=2)
+			;
+		if (m<M)
+			M=m;
+	}
+	a=make_node(ar,N);
+	if (a==NULL)
+		return NULL;
+	a->alg=ALG_CHIRP;
+	a->tsz=ws_part(M*sizeof(minfft_cmpl));
+	a->e=alloc_e(ar,a,(N+M)*sizeof(minfft_cmpl));
+	if (a->e==NULL)
+		return NULL;
+	a->sub1=make_aux_dft_1d(ar,M);
+	if (a->sub1==NULL)
+		return NULL;
+	c=a->e;
+	b=c+2*N;
+	// c[n]=exp(I*pi*n^2/N), with m=n^2 mod 2N
+	for (m=n=0; n<N; m=(m+2*n+1)%(2*N), ++n) {
+		c[2*n]=ncos(m,2*N);
+		c[2*n+1]=nsin(m,2*N);
+	}
+	// b is c, extended to negative n and wrapped around M
+	for (n=0; n<M; ++n)
+		b[2*n]=b[2*n+1]=0;
+	for (n=0; n<N; ++n) {
+		b[2*n]=b[2*(M-n)%(2*M)]=c[2*n];
+		b[2*n+1]=b[2*(M-n)%(2*M)+1]=c[2*n+1];
+	}
+	// replace b by its DFT, divided by M
+	wsz=minfft_workspace_size(a->sub1);
+	ws=arena_alloc(ar,wsz);
+	if (ws==NULL)
+		return NULL;
+	(*a->k->dft)((minfft_cmpl*)b,(minfft_cmpl*)b,1,a->sub1,ws);
+	arena_free(ar,ws,wsz);
+	for (n=0; n<2*M; ++n)
+		b[n]/=M;
+	return a;
+}
+
+// make aux data for one-dimensional complex DFT by the four-step algorithm
+static minfft_aux*
+make_aux_bailey_1d (struct arena *ar, ptrdiff_t N) {
+	minfft_aux *a;
+	ptrdiff_t N1,N2; // lengths of columns and rows
+	ptrdiff_t n; // counter
+	minfft_real *e;
+	// N1 is the largest divisor of N not greater than its square root
+	for (N1=n=1; n<=N/n; ++n)
+		if (N%n==0)
+			N1=n;
+	N2=N/N1;
+	a=make_node(ar,N);
+	if (a==NULL)
+		return NULL;
+	a->alg=ALG_BAILEY;
+	a->tsz=ws_part((BAILEY_BLK*(size_t)N2+N)*sizeof(minfft_cmpl));
+	a->e=alloc_e(ar,a,(N1+N2)*sizeof(minfft_cmpl));
+	if (a->e==NULL)
+		return NULL;
+	e=a->e;
+	// twiddle factors W_N^(N1*h+l) are products of W_N2^h and W_N^l
+	for (n=0; n<N1; ++n) {
+		*e++=ncos(-n,N);
+		*e++=nsin(-n,N);
+	}
+	for (n=0; n<N2; ++n) {
+		*e++=ncos(-n,N2);
+		*e++=nsin(-n,N2);
+	}
+	a->sub1=make_aux_dft_1d(ar,N1);
+	if (a->sub1==NULL)
+		return NULL;
+	a->sub2=make_aux_dft_1d(ar,N2);
+	if (a->sub2==NULL)
+		return NULL;
+	return a;
+}
+
+// make aux data for one-dimensional forward or inverse complex DFT
+static minfft_aux*
+make_aux_dft_1d (struct arena *ar, ptrdiff_t N) {
+	minfft_aux *a;
+	if (N<=0 || N>MAX_N)
+		// error if N is not positive or too large
+		return NULL;
+	if ((a=find_made(ar,AUX_DFT,N))!=NULL)
+		return a;
+	if (!smooth(N))
+		// prime factors other than 2, 3, 5, 7
+		return made(make_aux_chirp_1d(ar,N),AUX_DFT);
+	if (N>=BAILEY_MIN)
+		// long transforms whose data do not fit in cache
+		return made(make_aux_bailey_1d(ar,N),AUX_DFT);
+	a=make_node(ar,N);
+	if (a==NULL)
+		return NULL;
+	if (N>=16 || N&(N-1)) {
+		a->tsz=ws_part(N*sizeof(minfft_cmpl));
+		a->e=alloc_e(ar,a,N*sizeof(minfft_cmpl));
+		if (a->e==NULL)
+			return NULL;
+		fill_dft_e(a->e,N);
+	}
+	return made(a,AUX_DFT);
+}
+
+// make aux data for any-dimensional forward or inverse complex DFT
+static minfft_aux*
+make_aux_dft (struct arena *ar, int d, const ptrdiff_t *Ns) {
+	return make_aux(ar,d,Ns,sizeof(minfft_cmpl),make_aux_dft_1d);
+}
+
+// user interface
 minfft_aux*
-minfft_mkaux_realdft_1d (int N) {
+minfft_mkaux_dft_64 (int d, const ptrdiff_t *Ns) {
+	return make_cached(AUX_DFT,d,Ns);
+}
+minfft_aux*
+minfft_mkaux_dft_into (int d, const ptrdiff_t *Ns, void *buf, size_t len) {
+	return make_into(AUX_DFT,d,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_dft_1d (int N) {
+	ptrdiff_t Ns[1]={N};
+	return make_cached(AUX_DFT,1,Ns);
+}
+minfft_aux*
+minfft_mkaux_dft (int d, int *Ns) {
+	return make_aux_int(d,Ns,minfft_mkaux_dft_64);
+}
+
+// convenience routines for two- and three-dimensional complex DFT
+minfft_aux*
+minfft_mkaux_dft_2d (int N1, int N2) {
+	int Ns[2]={N1,N2};
+	return minfft_mkaux_dft(2,Ns);
+}
+minfft_aux*
+minfft_mkaux_dft_3d (int N1, int N2, int N3) {
+	int Ns[3]={N1,N2,N3};
+	return minfft_mkaux_dft(3,Ns);
+}
+
+// make aux data for one-dimensional forward or inverse real DFT
+static minfft_aux*
+make_aux_realdft_1d (struct arena *ar, ptrdiff_t N) {
 	minfft_aux *a;
-	int n;
+	ptrdiff_t n;
 	minfft_real *e;
-	if (N<=0 || N&(N-1))
-		// error if N is negative or not a power of two
+	if (N<=0 || N>MAX_N)
+		// error if N is not positive or too large
 		return NULL;
-	a=malloc(sizeof(minfft_aux));
+	if ((a=find_made(ar,AUX_REALDFT,N))!=NULL)
+		return a;
+	a=make_node(ar,N);
 	if (a==NULL)
-		goto err;
-	a->N=N;
-	if (N>=4) {
-		a->t=malloc((N/2)*sizeof(minfft_cmpl));
-		if (a->t==NULL)
-			goto err;
-		a->e=malloc((N/4)*sizeof(minfft_cmpl));
+		return NULL;
+	if (N%2 && N>1) {
+		// odd length: complex DFT of the same length
+		a->tsz=ws_part(N*sizeof(minfft_cmpl));
+		a->sub1=make_aux_dft_1d(ar,N);
+		if (a->sub1==NULL)
+			return NULL;
+	} else if (N>=4) {
+		a->tsz=ws_part((N/2)*sizeof(minfft_cmpl));
+		a->e=alloc_e(ar,a,((N+2)/4)*sizeof(minfft_cmpl));
 		if (a->e==NULL)
-			goto err;
+			return NULL;
 		e=(minfft_real*)a->e;
-		for (n=0; n<N/4; ++n) {
+		for (n=0; n<(N+2)/4; ++n) {
 			*e++=ncos(-n,N);
 			*e++=nsin(-n,N);
 		}
-		a->sub1=minfft_mkaux_dft_1d(N/2);
-	} else {
-		a->t=NULL;
-		a->e=NULL;
-		a->sub1=NULL;
+		a->sub1=make_aux_dft_1d(ar,N/2);
+		if (a->sub1==NULL)
+			return NULL;
 	}
-	a->sub2=NULL;
-	return a;
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
+	return made(a,AUX_REALDFT);
 }
 
 // make aux data for any-dimensional real DFT
-minfft_aux*
-minfft_mkaux_realdft (int d, int *Ns) {
+static minfft_aux*
+make_aux_realdft (struct arena *ar, int d, const ptrdiff_t *Ns) {
 	minfft_aux *a;
-	int p; // product of transform lengths
-	int i; // array index
-	if (d==1)
-		return minfft_mkaux_realdft_1d(Ns[0]);
+	ptrdiff_t p; // product of transform lengths
+	if (d<1)
+		return NULL;
+	else if (d==1)
+		return make_aux_realdft_1d(ar,Ns[0]);
 	else {
-		p=1;
-		for (i=0; i<d-1; ++i)
-			p*=Ns[i];
-		a=malloc(sizeof(minfft_aux));
+		p=product(d,Ns);
+		if (p==0)
+			return NULL;
+		p/=Ns[d-1];
+		a=make_node(ar,Ns[d-1]*p);
 		if (a==NULL)
-			goto err;
-		a->N=Ns[d-1]*p;
-		a->t=malloc((Ns[d-1]/2+1)*p*sizeof(minfft_cmpl));
-		if (a->t==NULL)
-			goto err;
-		a->e=NULL;
-		a->sub1=minfft_mkaux_realdft_1d(Ns[d-1]);
+			return NULL;
+		a->tsz=ws_part((Ns[d-1]/2+1)*p*sizeof(minfft_cmpl));
+		a->sub1=make_aux_realdft_1d(ar,Ns[d-1]);
 		if (a->sub1==NULL)
-			goto err;
-		a->sub2=minfft_mkaux_dft(d-1,Ns);
+			return NULL;
+		a->sub2=make_aux_dft(ar,d-1,Ns);
 		if (a->sub2==NULL)
-			goto err;
+			return NULL;
 		return a;
 	}
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
+}
+
+// user interface
+minfft_aux*
+minfft_mkaux_realdft_64 (int d, const ptrdiff_t *Ns) {
+	return make_cached(AUX_REALDFT,d,Ns);
+}
+minfft_aux*
+minfft_mkaux_realdft_into (int d, const ptrdiff_t *Ns, void *buf, size_t len) {
+	return make_into(AUX_REALDFT,d,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_realdft_1d (int N) {
+	ptrdiff_t Ns[1]={N};
+	return make_cached(AUX_REALDFT,1,Ns);
+}
+minfft_aux*
+minfft_mkaux_realdft (int d, int *Ns) {
+	return make_aux_int(d,Ns,minfft_mkaux_realdft_64);
 }
 
 // convenience routines for two- and three-dimensional real DFT
@@ -1197,48 +1311,53 @@ minfft_mkaux_realdft_3d (int N1, int N2, int N3) {
 }
 
 // make aux data for one-dimensional Type-2 or Type-3 transforms
-minfft_aux*
-minfft_mkaux_t2t3_1d (int N) {
+static minfft_aux*
+make_aux_t2t3_1d (struct arena *ar, ptrdiff_t N) {
 	minfft_aux *a;
-	int n;
+	ptrdiff_t n;
 	minfft_real *e;
-	if (N<=0 || N&(N-1))
-		// error if N is negative or not a power of two
+	if (N<=0 || N>MAX_N)
+		// error if N is not positive or too large
 		return NULL;
-	a=malloc(sizeof(minfft_aux));
+	if ((a=find_made(ar,AUX_T2T3,N))!=NULL)
+		return a;
+	a=make_node(ar,N);
 	if (a==NULL)
-		goto err;
-	a->N=N;
+		return NULL;
 	if (N>=2) {
-		a->t=malloc((N+2)*sizeof(minfft_real)); // for in-place real DFT
-		if (a->t==NULL)
-			goto err;
-		a->e=malloc((N/2)*sizeof(minfft_cmpl));
+		a->tsz=ws_part((N+2)*sizeof(minfft_real)); // for in-place real DFT
+		a->e=alloc_e(ar,a,((N+1)/2)*sizeof(minfft_cmpl));
 		if (a->e==NULL)
-			goto err;
+			return NULL;
 		e=(minfft_real*)a->e;
-		for (n=0; n<N/2; ++n) {
+		for (n=0; n<(N+1)/2; ++n) {
 			*e++=ncos(-n,4*N);
 			*e++=nsin(-n,4*N);
 		}
-	} else {
-		a->t=NULL;
-		a->e=NULL;
 	}
-	a->sub1=minfft_mkaux_realdft_1d(N);
+	a->sub1=make_aux_realdft_1d(ar,N);
 	if (a->sub1==NULL)
-		goto err;
-	a->sub2=NULL;
-	return a;
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
+		return NULL;
+	return made(a,AUX_T2T3);
 }
 
-// make aux data for any-dimensional Type-2 or Type-3 transforms
+// user interface
+minfft_aux*
+minfft_mkaux_t2t3_64 (int d, const ptrdiff_t *Ns) {
+	return make_cached(AUX_T2T3,d,Ns);
+}
+minfft_aux*
+minfft_mkaux_t2t3_into (int d, const ptrdiff_t *Ns, void *buf, size_t len) {
+	return make_into(AUX_T2T3,d,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_t2t3_1d (int N) {
+	ptrdiff_t Ns[1]={N};
+	return make_cached(AUX_T2T3,1,Ns);
+}
 minfft_aux*
 minfft_mkaux_t2t3 (int d, int *Ns) {
-	return make_aux(d,Ns,sizeof(minfft_real),minfft_mkaux_t2t3_1d);
+	return make_aux_int(d,Ns,minfft_mkaux_t2t3_64);
 }
 
 // convenience routines for two- and three-dimensional Type 2 or 3 transforms
@@ -1254,25 +1373,42 @@ minfft_mkaux_t2t3_3d (int N1, int N2, int N3) {
 }
 
 // make aux data for an one-dimensional Type-4 transform
-minfft_aux*
-minfft_mkaux_t4_1d (int N) {
+static minfft_aux*
+make_aux_t4_1d (struct arena *ar, ptrdiff_t N) {
 	minfft_aux *a;
-	int n;
+	ptrdiff_t n;
 	minfft_real *e;
-	if (N<=0 || N&(N-1))
-		// error if N is negative or not a power of two
+	if (N<=0 || N>MAX_N)
+		// error if N is not positive or too large
 		return NULL;
-	a=malloc(sizeof(minfft_aux));
+	if ((a=find_made(ar,AUX_T4,N))!=NULL)
+		return a;
+	a=make_node(ar,N);
 	if (a==NULL)
-		goto err;
-	a->N=N;
-	if (N>=2) {
-		a->t=malloc((N/2)*sizeof(minfft_cmpl));
-		if (a->t==NULL)
-			goto err;
-		a->e=malloc((N/2+N)*sizeof(minfft_cmpl));
+		return NULL;
+	if (N%2 && N>1) {
+		// odd length: complex DFT of the same length
+		a->tsz=ws_part(N*sizeof(minfft_cmpl));
+		a->e=alloc_e(ar,a,2*N*sizeof(minfft_cmpl));
 		if (a->e==NULL)
-			goto err;
+			return NULL;
+		e=(minfft_real*)a->e;
+		for (n=0; n<N; ++n) {
+			*e++=ncos(-n,4*N);
+			*e++=nsin(-n,4*N);
+		}
+		for (n=0; n<N; ++n) {
+			*e++=ncos(-(4*n+1),8*N);
+			*e++=nsin(-(4*n+1),8*N);
+		}
+		a->sub1=make_aux_dft_1d(ar,N);
+		if (a->sub1==NULL)
+			return NULL;
+	} else if (N>=2) {
+		a->tsz=ws_part((N/2)*sizeof(minfft_cmpl));
+		a->e=alloc_e(ar,a,(N/2+N)*sizeof(minfft_cmpl));
+		if (a->e==NULL)
+			return NULL;
 		e=(minfft_real*)a->e;
 		for (n=0; n<N/2; ++n) {
 			*e++=ncos(-n,2*N);
@@ -1282,25 +1418,30 @@ minfft_mkaux_t4_1d (int N) {
 			*e++=ncos(-(2*n+1),8*N);
 			*e++=nsin(-(2*n+1),8*N);
 		}
-		a->sub1=minfft_mkaux_dft_1d(N/2);
+		a->sub1=make_aux_dft_1d(ar,N/2);
 		if (a->sub1==NULL)
-			goto err;
-	} else {
-		a->t=NULL;
-		a->e=NULL;
-		a->sub1=NULL;
+			return NULL;
 	}
-	a->sub2=NULL;
-	return a;
-err:	// memory allocation error
-	minfft_free_aux(a);
-	return NULL;
+	return made(a,AUX_T4);
 }
 
-// make aux data for an any-dimensional Type-4 transform
+// user interface
+minfft_aux*
+minfft_mkaux_t4_64 (int d, const ptrdiff_t *Ns) {
+	return make_cached(AUX_T4,d,Ns);
+}
+minfft_aux*
+minfft_mkaux_t4_into (int d, const ptrdiff_t *Ns, void *buf, size_t len) {
+	return make_into(AUX_T4,d,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_t4_1d (int N) {
+	ptrdiff_t Ns[1]={N};
+	return make_cached(AUX_T4,1,Ns);
+}
 minfft_aux*
 minfft_mkaux_t4 (int d, int *Ns) {
-	return make_aux(d,Ns,sizeof(minfft_real),minfft_mkaux_t4_1d);
+	return make_aux_int(d,Ns,minfft_mkaux_t4_64);
 }
 
 // convenience routines for two- and three-dimensional Type 4 transforms
@@ -1315,14 +1456,527 @@ minfft_mkaux_t4_3d (int N1, int N2, int N3) {
 	return minfft_mkaux_t4(3,Ns);
 }
 
-// free aux chain
+// make aux data for a batch of one-dimensional transforms
+// with line buffers of size bsz
+static minfft_aux*
+make_aux_many (struct arena *ar, ptrdiff_t N, ptrdiff_t howmany, ptrdiff_t sx, ptrdiff_t dx, ptrdiff_t sy, ptrdiff_t dy, size_t bsz, minfft_aux* (*aux_1d)(struct arena*, ptrdiff_t)) {
+	minfft_aux *a,*l; // batch and line aux data
+	ptrdiff_t Ns[2]={howmany,N}; // shape of the batch
+	if (product(2,Ns)==0)
+		return NULL;
+	a=make_node(ar,N*howmany);
+	if (a==NULL)
+		return NULL;
+	a->sx=sx;
+	a->dx=dx;
+	a->sy=sy;
+	a->dy=dy;
+	// each task gathers and scatters the lines in its own workspace
+	l=a->sub1=make_node(ar,N);
+	if (l==NULL)
+		return NULL;
+	l->tsz=bsz;
+	l->sub1=(*aux_1d)(ar,N);
+	if (l->sub1==NULL)
+		return NULL;
+	return a;
+}
+
+// user interface
+minfft_aux*
+minfft_mkaux_dft_many_64 (ptrdiff_t N, ptrdiff_t howmany, ptrdiff_t sx, ptrdiff_t dx, ptrdiff_t sy, ptrdiff_t dy) {
+	ptrdiff_t Ns[6]={N,howmany,sx,dx,sy,dy};
+	return make_cached(AUX_DFT_MANY,6,Ns);
+}
+minfft_aux*
+minfft_mkaux_dft_many_into (ptrdiff_t N, ptrdiff_t howmany, ptrdiff_t sx, ptrdiff_t dx, ptrdiff_t sy, ptrdiff_t dy, void *buf, size_t len) {
+	ptrdiff_t Ns[6]={N,howmany,sx,dx,sy,dy};
+	return make_into(AUX_DFT_MANY,6,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_realdft_many_64 (ptrdiff_t N, ptrdiff_t howmany, ptrdiff_t sx, ptrdiff_t dx, ptrdiff_t sz, ptrdiff_t dz) {
+	ptrdiff_t Ns[6]={N,howmany,sx,dx,sz,dz};
+	return make_cached(AUX_REALDFT_MANY,6,Ns);
+}
+minfft_aux*
+minfft_mkaux_realdft_many_into (ptrdiff_t N, ptrdiff_t howmany, ptrdiff_t sx, ptrdiff_t dx, ptrdiff_t sz, ptrdiff_t dz, void *buf, size_t len) {
+	ptrdiff_t Ns[6]={N,howmany,sx,dx,sz,dz};
+	return make_into(AUX_REALDFT_MANY,6,Ns,buf,len);
+}
+minfft_aux*
+minfft_mkaux_dft_many (int N, int howmany, int sx, int dx, int sy, int dy) {
+	return minfft_mkaux_dft_many_64(N,howmany,sx,dx,sy,dy);
+}
+minfft_aux*
+minfft_mkaux_realdft_many (int N, int howmany, int sx, int dx, int sz, int dz) {
+	return minfft_mkaux_realdft_many_64(N,howmany,sx,dx,sz,dz);
+}
+
+// make aux data of a kind in an arena, with the lengths in Ns;
+// for batches, Ns holds N, howmany, and the strides and distances
+static minfft_aux*
+make_kind (struct arena *ar, int kind, int d, const ptrdiff_t *Ns) {
+	switch (kind) {
+	case AUX_DFT:
+		return make_aux(ar,d,Ns,sizeof(minfft_cmpl),make_aux_dft_1d);
+	case AUX_REALDFT:
+		return make_aux_realdft(ar,d,Ns);
+	case AUX_T2T3:
+		return make_aux(ar,d,Ns,sizeof(minfft_real),make_aux_t2t3_1d);
+	case AUX_T4:
+		return make_aux(ar,d,Ns,sizeof(minfft_real),make_aux_t4_1d);
+	case AUX_DFT_MANY:
+		return make_aux_many(ar,Ns[0],Ns[1],Ns[2],Ns[3],Ns[4],Ns[5],ws_part(Ns[0]*sizeof(minfft_cmpl)),make_aux_dft_1d);
+	case AUX_REALDFT_MANY:
+		return make_aux_many(ar,Ns[0],Ns[1],Ns[2],Ns[3],Ns[4],Ns[5],ws_part((Ns[0]/2+1)*sizeof(minfft_cmpl))+ws_part(Ns[0]*sizeof(minfft_real)),make_aux_realdft_1d);
+	default:
+		return NULL;
+	}
+}
+
+// make aux data with its workspace in a caller's block
+static minfft_aux*
+make_into (int kind, int d, const ptrdiff_t *Ns, void *buf, size_t len) {
+	struct arena ar;
+	minfft_aux *a;
+	size_t wsz; // workspace size
+	if (open_arena(&ar,buf,len))
+		return NULL;
+	a=make_kind(&ar,kind,d,Ns);
+	if (a==NULL)
+		return NULL;
+	wsz=ws_part(minfft_workspace_size(a));
+	// the block may need WS_ALIGN bytes more for alignment
+	a->msz=arena_size(&ar)+wsz+WS_ALIGN;
+	a->w=arena_alloc(&ar,wsz);
+	if (a->w==NULL)
+		return NULL;
+	if (wsz==0)
+		a->w=NULL;
+	a->t=a->w;
+	a->wsz=wsz;
+	return a;
+}
+
+// aux tree shared by the aux data of equal transforms
+struct cache_entry {
+	struct cache_entry *next; // next entry of the cache
+	int refs; // number of users
+	minfft_aux *a; // the tree, following this structure
+	size_t msz; // memory taken by aux data made in a caller's block
+	// key: allocator, kind, and lengths of the transform
+	minfft_alloc *alloc;
+	minfft_dealloc *dealloc;
+	void *actx;
+	int kind;
+	int d;
+	ptrdiff_t Ns[];
+};
+
+// list of cache entries, guarded by a critical section
+static struct cache_entry *cache;
+
+// find an entry of the cache and take a reference to it
+static struct cache_entry*
+cache_find (int kind, int d, const ptrdiff_t *Ns) {
+	struct cache_entry *c;
+	int i; // array index
+#ifdef _OPENMP
+	#pragma omp critical(minfft_cache)
+#endif
+	{
+		for (c=cache; c!=NULL; c=c->next) {
+			if (c->kind!=kind || c->d!=d || c->alloc!=alloc_hook || c->dealloc!=dealloc_hook || c->actx!=alloc_ctx)
+				continue;
+			for (i=0; i<d && c->Ns[i]==Ns[i]; ++i)
+				;
+			if (i==d) {
+				++c->refs;
+				break;
+			}
+		}
+	}
+	return c;
+}
+
+// add an entry to the cache
+static void
+cache_add (struct cache_entry *c) {
+#ifdef _OPENMP
+	#pragma omp critical(minfft_cache)
+#endif
+	{
+		c->next=cache;
+		cache=c;
+	}
+}
+
+// drop a reference to an entry of the cache, freeing it if not used
+static void
+cache_drop (struct cache_entry *c) {
+	struct cache_entry **p; // link to the entry
+	int refs; // references left
+#ifdef _OPENMP
+	#pragma omp critical(minfft_cache)
+#endif
+	{
+		refs=--c->refs;
+		if (refs==0) {
+			for (p=&cache; *p!=c; p=&(*p)->next)
+				;
+			*p=c->next;
+		}
+	}
+	if (refs==0)
+		free_aligned(c->dealloc,c->actx,c);
+}
+
+// make a cache entry for a transform, packing its tree made in the heap
+static struct cache_entry*
+make_entry (int kind, int d, const ptrdiff_t *Ns) {
+	struct arena ar={NULL,0,NULL};
+	struct cache_entry *c;
+	minfft_aux *a;
+	size_t hsz,tsz; // sizes of the header and of the tree
+	int i; // array index
+	a=make_kind(&ar,kind,d,Ns);
+	if (a==NULL) {
+		drop_arena(&ar);
+		return NULL;
+	}
+	hsz=ws_part(sizeof(struct cache_entry)+d*sizeof(ptrdiff_t));
+	tsz=arena_size(&ar);
+	c=alloc_aligned(alloc_hook,alloc_ctx,hsz+tsz);
+	if (c==NULL) {
+		drop_arena(&ar);
+		return NULL;
+	}
+	c->refs=1;
+	c->a=pack_arena(&ar,a,(char*)c+hsz);
+	drop_arena(&ar);
+	c->msz=tsz+ws_part(minfft_workspace_size(c->a))+WS_ALIGN;
+	c->alloc=alloc_hook;
+	c->dealloc=dealloc_hook;
+	c->actx=alloc_ctx;
+	c->kind=kind;
+	c->d=d;
+	for (i=0; i<d; ++i)
+		c->Ns[i]=Ns[i];
+	return c;
+}
+
+// make aux data from the tree of a cached transform: only the top-level
+// structure and the workspace are its own, and the rest is shared
+static minfft_aux*
+make_cached (int kind, int d, const ptrdiff_t *Ns) {
+	struct cache_entry *c;
+	minfft_aux *a;
+	size_t wsz; // workspace size
+	if (d<1)
+		return NULL;
+	c=cache_find(kind,d,Ns);
+	if (c==NULL) {
+		c=make_entry(kind,d,Ns);
+		if (c==NULL)
+			return NULL;
+		cache_add(c);
+	}
+	wsz=ws_part(minfft_workspace_size(c->a));
+	a=alloc_aligned(c->alloc,c->actx,ws_part(sizeof(minfft_aux))+wsz);
+	if (a==NULL) {
+		cache_drop(c);
+		return NULL;
+	}
+	*a=*c->a;
+	a->mem=a;
+	a->msz=c->msz;
+	a->w=wsz>0?(char*)a+ws_part(sizeof(minfft_aux)):NULL;
+	a->t=a->w;
+	a->wsz=wsz;
+	a->ce=c;
+	return a;
+}
+
+// size of the workspace required by a transform
+size_t
+minfft_workspace_size (const minfft_aux *a) {
+	size_t sz1,sz2; // workspace sizes of subtransforms
+	if (a==NULL)
+		return 0;
+	sz1=minfft_workspace_size(a->sub1);
+	sz2=minfft_workspace_size(a->sub2);
+	if (a->nt>1)
+		// separate workspaces for parallel tasks
+		return a->tsz+a->nt*ws_part(blk_size(a)+(sz1>sz2?sz1:sz2));
+	else
+		return a->tsz+blk_size(a)+(sz1>sz2?sz1:sz2);
+}
+
+// split the work of a transform between parallel tasks
+int
+minfft_set_dispatch (minfft_aux *a, int nt, minfft_dispatch *disp, void *ctx) {
+	minfft_aux b=*a; // new aux data
+	size_t sz; // new workspace size
+	void *t; // new workspace
+	if (nt<1 || (nt>1 && disp==NULL))
+		return -1;
+	b.nt=nt;
+	b.disp=disp;
+	b.dctx=ctx;
+	sz=minfft_workspace_size(&b);
+	if (sz<=a->wsz)
+		// the workspace of the memory block is enough
+		t=a->w;
+	else {
+		t=mem_alloc(a,sz);
+		if (t==NULL)
+			return -1;
+	}
+	if (a->t!=a->w)
+		mem_free(a,a->t);
+	*a=b;
+	a->t=t;
+	return 0;
+}
+
+#ifdef _OPENMP
+// run tasks by OpenMP threads
+static void
+omp_dispatch (minfft_task *task, void *arg, int nt, void *ctx) {
+	int k; // counter
+	(void)ctx;
+	#pragma omp parallel for num_threads(nt) schedule(static,1)
+	for (k=0; k<nt; ++k)
+		(*task)(arg,k);
+}
+#endif
+
+// run a transform by a number of built-in threads
+int
+minfft_set_threads (minfft_aux *a, int nthreads) {
+	if (nthreads==1)
+		return minfft_set_dispatch(a,1,NULL,NULL);
+#ifdef _OPENMP
+	return minfft_set_dispatch(a,nthreads,omp_dispatch,NULL);
+#else
+	// no built-in threads
+	return -1;
+#endif
+}
+
+// free aux data
 void
 minfft_free_aux (minfft_aux *a) {
 	if (a==NULL)
 		return;
-	free(a->t);
-	free(a->e);
-	minfft_free_aux(a->sub1);
-	minfft_free_aux(a->sub2);
-	free(a);
+	if (a->t!=a->w)
+		mem_free(a,a->t);
+	if (a->ce!=NULL)
+		cache_drop(a->ce);
+	// the memory block holds the top-level structure itself
+	mem_free(a,a->mem);
+}
+
+// size of the memory taken by aux data
+size_t
+minfft_aux_size (const minfft_aux *a) {
+	return a->msz;
+}
+
+// set allocator hooks for the aux data made from now on
+int
+minfft_set_alloc (minfft_alloc *alloc, minfft_dealloc *dealloc, void *ctx) {
+	if ((alloc==NULL)!=(dealloc==NULL))
+		return -1;
+	alloc_hook=alloc;
+	dealloc_hook=dealloc;
+	alloc_ctx=ctx;
+	return 0;
+}
+
+// *** export and import of aux data ***
+
+// an exported aux tree is an image of the following format, in the byte
+// order of the writer: a header, the nodes, children before their parents
+// and the top-level one last, and the exponent vectors, each part aligned
+// to WS_ALIGN bytes from the beginning of the image
+#define IMAGE_MAGIC "minfft\0\0"
+#define IMAGE_VERSION 1
+#define IMAGE_ORDER 0x01020304
+
+// header of an image
+struct image_header {
+	char magic[8]; // IMAGE_MAGIC
+	uint32_t version; // IMAGE_VERSION
+	uint32_t realsz; // sizeof(minfft_real)
+	uint32_t order; // IMAGE_ORDER
+	uint32_t n; // number of nodes
+	uint64_t size; // size of the image
+};
+
+// node of an image
+struct image_node {
+	int64_t N; // number of elements to transform
+	int64_t sx,dx,sy,dy; // strides and distances of a batch of transforms
+	uint64_t tsz; // size of own part of the workspace
+	uint64_t esz; // size of the exponent vector
+	uint64_t eoff; // its offset from the beginning of the image
+	int32_t alg; // algorithm of a one-dimensional complex DFT
+	int32_t kind; // kind of a one-dimensional transform
+	int32_t sub1,sub2; // indices of the subtransforms, or -1
+};
+
+// number of paths to the nodes of an aux tree, not less than the number of nodes
+static size_t
+count_nodes (const minfft_aux *a) {
+	if (a==NULL)
+		return 0;
+	return 1+count_nodes(a->sub1)+count_nodes(a->sub2);
+}
+
+// index of a node in a list of n nodes, or -1
+static int
+node_index (const minfft_aux *a, const minfft_aux **nodes, int n) {
+	int i; // array index
+	for (i=0; i<n; ++i)
+		if (nodes[i]==a)
+			return i;
+	return -1;
+}
+
+// list the nodes of an aux tree once each, children before their parents
+static void
+list_nodes (const minfft_aux *a, const minfft_aux **nodes, int *n) {
+	if (a==NULL || node_index(a,nodes,*n)>=0)
+		return;
+	list_nodes(a->sub1,nodes,n);
+	list_nodes(a->sub2,nodes,n);
+	nodes[(*n)++]=a;
+}
+
+// export aux data to an image of len bytes at buf, returning its size
+size_t
+minfft_export (const minfft_aux *a, void *buf, size_t len) {
+	const minfft_aux **nodes; // nodes of the tree
+	int n; // number of nodes
+	struct image_header h;
+	struct image_node r;
+	size_t hsz,off,sz; // sizes of the header and the nodes, offset, and size
+	char *p=buf;
+	int i; // array index
+	nodes=malloc(count_nodes(a)*sizeof(*nodes));
+	if (nodes==NULL)
+		return 0;
+	n=0;
+	list_nodes(a,nodes,&n);
+	hsz=ws_part(sizeof(h))+ws_part(n*sizeof(r));
+	sz=hsz;
+	for (i=0; i<n; ++i)
+		sz+=ws_part(nodes[i]->esz);
+	if (p!=NULL && len>=sz) {
+		memset(p,0,sz);
+		memcpy(h.magic,IMAGE_MAGIC,8);
+		h.version=IMAGE_VERSION;
+		h.realsz=sizeof(minfft_real);
+		h.order=IMAGE_ORDER;
+		h.n=n;
+		h.size=sz;
+		memcpy(p,&h,sizeof(h));
+		off=hsz;
+		for (i=0; i<n; ++i) {
+			r.N=nodes[i]->N;
+			r.sx=nodes[i]->sx;
+			r.dx=nodes[i]->dx;
+			r.sy=nodes[i]->sy;
+			r.dy=nodes[i]->dy;
+			r.tsz=nodes[i]->tsz;
+			r.esz=nodes[i]->esz;
+			r.eoff=nodes[i]->e!=NULL?off:0;
+			r.alg=nodes[i]->alg;
+			r.kind=nodes[i]->kind;
+			r.sub1=node_index(nodes[i]->sub1,nodes,n);
+			r.sub2=node_index(nodes[i]->sub2,nodes,n);
+			memcpy(p+ws_part(sizeof(h))+i*sizeof(r),&r,sizeof(r));
+			if (nodes[i]->e!=NULL) {
+				memcpy(p+off,nodes[i]->e,nodes[i]->esz);
+				off+=ws_part(nodes[i]->esz);
+			}
+		}
+	}
+	free(nodes);
+	return sz;
+}
+
+// import aux data from an image of len bytes at buf, whose exponent
+// vectors are used in place
+minfft_aux*
+minfft_import (const void *buf, size_t len) {
+	struct image_header h;
+	struct image_node r;
+	minfft_aux *a,*b; // block of the nodes, and a node
+	size_t hsz,wsz; // sizes of the header and the nodes, and of the workspace
+	const char *p=buf;
+	uint32_t i; // array index
+	if (p==NULL || len<sizeof(h))
+		return NULL;
+	memcpy(&h,p,sizeof(h));
+	if (memcmp(h.magic,IMAGE_MAGIC,8) || h.version!=IMAGE_VERSION || h.realsz!=sizeof(minfft_real) || h.order!=IMAGE_ORDER)
+		// not an image of aux data of this library
+		return NULL;
+	if (h.size>len || h.n<1 || h.n>len/sizeof(r))
+		return NULL;
+	hsz=ws_part(sizeof(h))+ws_part(h.n*sizeof(r));
+	if (hsz>h.size)
+		return NULL;
+	a=alloc_aligned(alloc_hook,alloc_ctx,h.n*ws_part(sizeof(minfft_aux)));
+	if (a==NULL)
+		return NULL;
+	for (i=0; i<h.n; ++i) {
+		memcpy(&r,p+ws_part(sizeof(h))+i*sizeof(r),sizeof(r));
+		// subtransforms come first, and exponent vectors lie in the image
+		if (r.sub1>=(int64_t)i || r.sub2>=(int64_t)i || r.sub1<-1 || r.sub2<-1)
+			goto err;
+		if (r.alg<ALG_RADIX || r.alg>ALG_BAILEY || r.N<=0 || r.N>MAX_N)
+			goto err;
+		if (r.esz>0 && (r.eoff<hsz || r.eoff>h.size || r.esz>h.size-r.eoff))
+			goto err;
+		b=(minfft_aux*)((char*)a+i*ws_part(sizeof(minfft_aux)));
+		b->alloc=alloc_hook;
+		b->dealloc=dealloc_hook;
+		b->actx=alloc_ctx;
+		b->N=r.N;
+		b->alg=r.alg;
+		b->tsz=r.tsz;
+		b->t=NULL;
+		b->esz=r.esz;
+		b->e=r.esz>0?(void*)(p+r.eoff):NULL;
+		b->sub1=r.sub1>=0?(minfft_aux*)((char*)a+r.sub1*ws_part(sizeof(minfft_aux))):NULL;
+		b->sub2=r.sub2>=0?(minfft_aux*)((char*)a+r.sub2*ws_part(sizeof(minfft_aux))):NULL;
+		b->nt=1;
+		b->disp=NULL;
+		b->dctx=NULL;
+		b->k=kernels();
+		b->sx=r.sx;
+		b->dx=r.dx;
+		b->sy=r.sy;
+		b->dy=r.dy;
+		b->kind=r.kind;
+		b->next=b->copy=NULL;
+		b->mem=b->w=NULL;
+		b->msz=b->wsz=0;
+		b->ce=NULL;
+	}
+	// the top-level node is the last one
+	b->mem=a;
+	wsz=minfft_workspace_size(b);
+	if (wsz>0) {
+		b->t=mem_alloc(b,wsz);
+		if (b->t==NULL)
+			goto err;
+	}
+	b->msz=h.n*ws_part(sizeof(minfft_aux))+ws_part(wsz);
+	return b;
+err:	// invalid image or memory allocation error
+	free_aligned(dealloc_hook,alloc_ctx,a);
+	return NULL;
 }
@@ -5,6 +5,8 @@
 #ifndef MINFFT_H
 #define MINFFT_H
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -46,6 +48,26 @@ void minfft_dst3 (minfft_real*, minfft_real*, const minfft_aux*);
 void minfft_dct4 (minfft_real*, minfft_real*, const minfft_aux*);
 void minfft_dst4 (minfft_real*, minfft_real*, const minfft_aux*);
 
+void minfft_dft_many (minfft_cmpl*, minfft_cmpl*, const minfft_aux*);
+void minfft_invdft_many (minfft_cmpl*, minfft_cmpl*, const minfft_aux*);
+void minfft_realdft_many (minfft_real*, minfft_cmpl*, const minfft_aux*);
+void minfft_invrealdft_many (minfft_cmpl*, minfft_real*, const minfft_aux*);
+
+void minfft_dft_ws (minfft_cmpl*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_invdft_ws (minfft_cmpl*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_realdft_ws (minfft_real*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_invrealdft_ws (minfft_cmpl*, minfft_real*, const minfft_aux*, void*);
+void minfft_dct2_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dst2_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dct3_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dst3_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dct4_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dst4_ws (minfft_real*, minfft_real*, const minfft_aux*, void*);
+void minfft_dft_many_ws (minfft_cmpl*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_invdft_many_ws (minfft_cmpl*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_realdft_many_ws (minfft_real*, minfft_cmpl*, const minfft_aux*, void*);
+void minfft_invrealdft_many_ws (minfft_cmpl*, minfft_real*, const minfft_aux*, void*);
+
 minfft_aux* minfft_mkaux_dft_1d (int);
 minfft_aux* minfft_mkaux_dft_2d (int, int);
 minfft_aux* minfft_mkaux_dft_3d (int, int, int);
@@ -62,6 +84,35 @@ minfft_aux* minfft_mkaux_t4_1d (int);
 minfft_aux* minfft_mkaux_t4_2d (int, int);
 minfft_aux* minfft_mkaux_t4_3d (int, int, int);
 minfft_aux* minfft_mkaux_t4 (int, int*);
+minfft_aux* minfft_mkaux_dft_many (int, int, int, int, int, int);
+minfft_aux* minfft_mkaux_realdft_many (int, int, int, int, int, int);
+minfft_aux* minfft_mkaux_dft_64 (int, const ptrdiff_t*);
+minfft_aux* minfft_mkaux_realdft_64 (int, const ptrdiff_t*);
+minfft_aux* minfft_mkaux_t2t3_64 (int, const ptrdiff_t*);
+minfft_aux* minfft_mkaux_t4_64 (int, const ptrdiff_t*);
+minfft_aux* minfft_mkaux_dft_many_64 (ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t);
+minfft_aux* minfft_mkaux_realdft_many_64 (ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t);
+minfft_aux* minfft_mkaux_dft_into (int, const ptrdiff_t*, void*, size_t);
+minfft_aux* minfft_mkaux_realdft_into (int, const ptrdiff_t*, void*, size_t);
+minfft_aux* minfft_mkaux_t2t3_into (int, const ptrdiff_t*, void*, size_t);
+minfft_aux* minfft_mkaux_t4_into (int, const ptrdiff_t*, void*, size_t);
+minfft_aux* minfft_mkaux_dft_many_into (ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, void*, size_t);
+minfft_aux* minfft_mkaux_realdft_many_into (ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, ptrdiff_t, void*, size_t);
+
+size_t minfft_workspace_size (const minfft_aux*);
+size_t minfft_aux_size (const minfft_aux*);
+
+typedef void minfft_task (void*, int);
+typedef void minfft_dispatch (minfft_task*, void*, int, void*);
+int minfft_set_dispatch (minfft_aux*, int, minfft_dispatch*, void*);
+int minfft_set_threads (minfft_aux*, int);
+
+typedef void* minfft_alloc (size_t, void*);
+typedef void minfft_dealloc (void*, void*);
+int minfft_set_alloc (minfft_alloc*, minfft_dealloc*, void*);
+
+size_t minfft_export (const minfft_aux*, void*, size_t);
+minfft_aux* minfft_import (const void*, size_t);
 
 void minfft_free_aux (minfft_aux*);
 
@@ -0,0 +1,8 @@
+// A minimalistic FFT library
+// Copyright (c) 2016-2022 Alexander Mukhin
+// SPDX-License-Identifier: MIT
+
+// the kernels for processors with AVX-512F,
+// selected at run time when built with MINFFT_DISPATCH
+#define MINFFT_KERNELS minfft_kernels_avx512
+#include "minfft_kernels.h"
@@ -0,0 +1,1381 @@
+// A minimalistic FFT library
+// Copyright (c) 2016-2022 Alexander Mukhin
+// SPDX-License-Identifier: MIT
+
+// One-dimensional transform kernels, internal to the library.
+// This file is included once by every source file that builds
+// the kernels for some instruction set. The includer defines
+// MINFFT_KERNELS as the name of the resulting kernel table.
+
+#include "minfft.h"
+#include "minfft_simd.h"
+
+// constants
+static const minfft_real sqrt2=1.414213562373095048801688724209698079L;
+static const minfft_real invsqrt2=0.707106781186547524400844362104849039L;
+
+// a pointer to a strided 1d complex transform routine
+typedef
+void (*s_cx_1d_t)
+(minfft_cmpl*,minfft_cmpl*,ptrdiff_t,const minfft_aux*,void*);
+
+// a pointer to a strided 1d real transform routine
+typedef
+void (*s_rx_1d_t)
+(minfft_real*,minfft_real*,ptrdiff_t,const minfft_aux*,void*);
+
+// one-dimensional transforms built for one instruction set
+struct minfft_kernels {
+	s_cx_1d_t dft,invdft;
+	void (*realdft)(minfft_real*,minfft_cmpl*,ptrdiff_t,const minfft_aux*,void*);
+	void (*invrealdft)(minfft_cmpl*,minfft_real*,const minfft_aux*,void*);
+	s_rx_1d_t dct2,dst2,dct3,dst3,dct4,dst4;
+};
+
+// aux structure
+struct minfft_aux {
+	ptrdiff_t N; // number of elements to transform
+	int alg; // algorithm of a one-dimensional complex DFT
+	size_t tsz; // size of own part of the workspace in bytes
+	void *t; // workspace for the user interface (top-level structure only)
+	size_t esz; // size of the exponent vector in bytes
+	void *e; // exponent vector
+	struct minfft_aux *sub1; // subtransform structure
+	struct minfft_aux *sub2; // subtransform structure
+	int nt; // number of parallel tasks
+	minfft_dispatch *disp; // task dispatcher
+	void *dctx; // its context
+	const struct minfft_kernels *k; // kernels for the running processor
+	ptrdiff_t sx,dx,sy,dy; // strides and distances of a batch of transforms
+	minfft_alloc *alloc; // allocator of the buffers
+	minfft_dealloc *dealloc; // its deallocator
+	void *actx; // their context
+	int kind; // kind of a one-dimensional transform shared by its users
+	struct minfft_aux *next; // next node made in the same memory
+	struct minfft_aux *copy; // copy of the node in a memory block
+	void *mem; // memory block of the top-level structure, if allocated by us
+	size_t msz; // size of the memory taken by the aux data
+	void *w; // workspace in the memory block
+	size_t wsz; // its size
+	struct cache_entry *ce; // cache entry holding the shared aux tree
+};
+
+// algorithms of one-dimensional complex DFT
+#define ALG_RADIX 0 // mixed-radix recursion, for N=2^a*3^b*5^c*7^d
+#define ALG_CHIRP 1 // chirp-z convolution, for any other N
+#define ALG_BAILEY 2 // four-step algorithm, for large N
+
+// number of subtransforms done at once by a stage of a multi-dimensional
+// transform: their outputs are interleaved in a block buffer of the task,
+// which is then copied to the destination in short contiguous runs
+#define BLK 8
+// the same for the steps of the four-step algorithm, whose columns are
+// gathered from many pages: wider blocks use each page more
+#define BAILEY_BLK 32
+
+// a workspace of a transform begins with its own temporary buffer,
+// followed by the workspace shared by its subtransforms
+inline static void*
+sub_ws (void *ws, const minfft_aux *a) {
+	return (char*)ws+a->tsz;
+}
+
+// *** complex transforms ***
+
+// cos(2*pi*m/p) and sin(2*pi*m/p) for the odd radices p=3,5,7
+static const minfft_real ocos[3][7]={
+	{1,-0.5L,-0.5L},
+	{1,0.309016994374947424102293417182819059L,-0.809016994374947424102293417182819059L,
+	-0.809016994374947424102293417182819059L,0.309016994374947424102293417182819059L},
+	{1,0.623489801858733530525004884004239811L,-0.222520933956314404288902564496794759L,
+	-0.900968867902419126236102319507445051L,-0.900968867902419126236102319507445051L,
+	-0.222520933956314404288902564496794759L,0.623489801858733530525004884004239811L}
+};
+static const minfft_real osin[3][7]={
+	{0,0.866025403784438646763723170752936183L,-0.866025403784438646763723170752936183L},
+	{0,0.951056516295153572116439333379382143L,0.587785252292473129168705954639072769L,
+	-0.587785252292473129168705954639072769L,-0.951056516295153572116439333379382143L},
+	{0,0.781831482468029808708444526674057750L,0.974927912181823607018131682993931217L,
+	0.433883739117558120475768332848358755L,-0.433883739117558120475768332848358755L,
+	-0.974927912181823607018131682993931217L,-0.781831482468029808708444526674057750L}
+};
+
+// prototypes
+static void rs_dft_1d (ptrdiff_t, minfft_cmpl*, minfft_cmpl*, minfft_cmpl*, ptrdiff_t, const minfft_cmpl*);
+static void rs_invdft_1d (ptrdiff_t, minfft_cmpl*, minfft_cmpl*, minfft_cmpl*, ptrdiff_t, const minfft_cmpl*);
+inline static void s_dft_1d (minfft_cmpl*, minfft_cmpl*, ptrdiff_t, const minfft_aux*, void*);
+inline static void s_invdft_1d (minfft_cmpl*, minfft_cmpl*, ptrdiff_t, const minfft_aux*, void*);
+
+// radix-p step of the recursive strided one-dimensional DFT (inv=0)
+// or inverse DFT (inv=1), for odd p
+// p-point DFTs of x[n+j*N/p], j=0..p-1, multiplied by e^(-+2*pi*I*n*k/N),
+// become the inputs of the p sub-transforms of length N/p
+inline static void
+rs_odd_1d (int p, int inv, ptrdiff_t N, minfft_cmpl *x, minfft_cmpl *t, minfft_cmpl *y, ptrdiff_t sy, const minfft_cmpl *e) {
+	ptrdiff_t L=N/p; // sub-transform length
+	ptrdiff_t n; // counter
+	int j,k; // counters
+	const minfft_real *c=ocos[p/2-1],*s=osin[p/2-1]; // roots of unity
+	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *xi=xr+1,*ti=tr+1,*ei=er+1;
+	n=0;
+#ifdef MINFFT_VC
+	// vectorized part
+	for (; L>1 && n+MINFFT_VC<=L; n+=MINFFT_VC) {
+		v_t a[3],b[3]; // sums and differences of symmetric inputs
+		v_t x0,u0,r,d,w;
+		x0=v_ld(xr+2*n);
+		u0=x0;
+		for (j=1; 2*j<p; ++j) {
+			v_t x1=v_ld(xr+2*(n+j*L)),x2=v_ld(xr+2*(n+(p-j)*L));
+			a[j-1]=v_add(x1,x2);
+			b[j-1]=v_sub(x1,x2);
+			u0=v_add(u0,a[j-1]);
+		}
+		v_st(tr+2*n,u0);
+		for (k=1; 2*k<p; ++k) {
+			// u[k]=r-I*d, u[p-k]=r+I*d for the forward transform
+			r=x0;
+			d=v_mul(v_set1(s[k]),b[0]);
+			r=v_add(r,v_mul(v_set1(c[k]),a[0]));
+			for (j=2; 2*j<p; ++j) {
+				r=v_add(r,v_mul(v_set1(c[j*k%p]),a[j-1]));
+				d=v_add(d,v_mul(v_set1(s[j*k%p]),b[j-1]));
+			}
+			d=v_muli(d);
+			if (inv) {
+				w=v_ld(er+2*((k-1)*L+n));
+				v_st(tr+2*(n+k*L),v_cmulwc(v_add(r,d),w));
+				w=v_ld(er+2*((p-k-1)*L+n));
+				v_st(tr+2*(n+(p-k)*L),v_cmulwc(v_sub(r,d),w));
+			} else {
+				w=v_ld(er+2*((k-1)*L+n));
+				v_st(tr+2*(n+k*L),v_cmulw(v_sub(r,d),w));
+				w=v_ld(er+2*((p-k-1)*L+n));
+				v_st(tr+2*(n+(p-k)*L),v_cmulw(v_add(r,d),w));
+			}
+		}
+	}
+#endif
+	for (; n<L; ++n) {
+		minfft_real ar[3],br[3]; // sums and differences of symmetric inputs
+		minfft_real ai[3],bi[3];
+		minfft_real ur[7],ui[7]; // outputs of the p-point DFT
+		register minfft_real rr,dr,wr;
+		register minfft_real ri,di,wi;
+		ur[0]=xr[2*n];
+		ui[0]=xi[2*n];
+		for (j=1; 2*j<p; ++j) {
+			// a[j]=x[n+j*L]+x[n+(p-j)*L];
+			ar[j-1]=xr[2*(n+j*L)]+xr[2*(n+(p-j)*L)];
+			ai[j-1]=xi[2*(n+j*L)]+xi[2*(n+(p-j)*L)];
+			// b[j]=x[n+j*L]-x[n+(p-j)*L];
+			br[j-1]=xr[2*(n+j*L)]-xr[2*(n+(p-j)*L)];
+			bi[j-1]=xi[2*(n+j*L)]-xi[2*(n+(p-j)*L)];
+			ur[0]+=ar[j-1];
+			ui[0]+=ai[j-1];
+		}
+		for (k=1; 2*k<p; ++k) {
+			// r=x[n]+sum(a[j]*cos(2*pi*j*k/p));
+			// d=sum(b[j]*sin(2*pi*j*k/p));
+			rr=xr[2*n];
+			ri=xi[2*n];
+			dr=di=0;
+			for (j=1; 2*j<p; ++j) {
+				rr+=c[j*k%p]*ar[j-1];
+				ri+=c[j*k%p]*ai[j-1];
+				dr+=s[j*k%p]*br[j-1];
+				di+=s[j*k%p]*bi[j-1];
+			}
+			if (inv) {
+				dr=-dr;
+				di=-di;
+			}
+			// u[k]=r-I*d;
+			ur[k]=rr+di;
+			ui[k]=ri-dr;
+			// u[p-k]=r+I*d;
+			ur[p-k]=rr-di;
+			ui[p-k]=ri+dr;
+		}
+		if (L==1) {
+			// terminal case
+			minfft_real *yr=(minfft_real*)y,*yi=yr+1;
+			for (k=0; k<p; ++k) {
+				yr[2*sy*k]=ur[k];
+				yi[2*sy*k]=ui[k];
+			}
+			return;
+		}
+		// t[n]=u[0];
+		tr[2*n]=ur[0];
+		ti[2*n]=ui[0];
+		for (k=1; k<p; ++k) {
+			// t[n+k*L]=u[k]*e[(k-1)*L+n], or with conj(e) for inverse
+			wr=er[2*((k-1)*L+n)];
+			wi=inv?-ei[2*((k-1)*L+n)]:ei[2*((k-1)*L+n)];
+			tr[2*(n+k*L)]=ur[k]*wr-ui[k]*wi;
+			ti[2*(n+k*L)]=ur[k]*wi+ui[k]*wr;
+		}
+	}
+	// call sub-transforms
+	for (k=0; k<p; ++k)
+		if (inv)
+			rs_invdft_1d(L,t+k*L,t+k*L,y+k*sy,p*sy,e+(p-1)*L);
+		else
+			rs_dft_1d(L,t+k*L,t+k*L,y+k*sy,p*sy,e+(p-1)*L);
+}
+
+// recursive strided one-dimensional DFT
+inline static void
+rs_dft_1d (ptrdiff_t N, minfft_cmpl *x, minfft_cmpl *t, minfft_cmpl *y, ptrdiff_t sy, const minfft_cmpl *e) {
+	ptrdiff_t n; // counter
+	if (N&(N-1)) {
+		// the odd factors of N come first
+		if (N%7==0)
+			rs_odd_1d(7,0,N,x,t,y,sy,e);
+		else if (N%5==0)
+			rs_odd_1d(5,0,N,x,t,y,sy,e);
+		else
+			rs_odd_1d(3,0,N,x,t,y,sy,e);
+		return;
+	}
+	// split-radix DIF
+	if (N==1) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		// y[0]=x[0];
+		yr[0]=xr[0];
+		yi[0]=xi[0];
+		return;
+	}
+	if (N==2) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r;
+		register minfft_real t0i,t1i;
+		// t0=x[0]+x[1];
+		t0r=xr[0]+xr[2];
+		t0i=xi[0]+xi[2];
+		// t1=x[0]-x[1];
+		t1r=xr[0]-xr[2];
+		t1i=xi[0]-xi[2];
+		// y[0]=t0;
+		yr[0]=t0r;
+		yi[0]=t0i;
+		// y[sy]=t1;
+		yr[2*sy]=t1r;
+		yi[2*sy]=t1i;
+		return;
+	}
+#ifdef MINFFT_C1
+	if (N==4) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		c_t x0,x1,x2,x3;
+		c_t t0,t1,t2,t3;
+		x0=c_ld(xr);
+		x1=c_ld(xr+2);
+		x2=c_ld(xr+4);
+		x3=c_ld(xr+6);
+		t0=c_add(x0,x2);
+		t1=c_add(x1,x3);
+		t2=c_sub(x0,x2);
+		t3=c_muli(c_sub(x1,x3));
+		c_st(yr,c_add(t0,t1));
+		c_st(yr+2*sy,c_sub(t2,t3));
+		c_st(yr+4*sy,c_sub(t0,t1));
+		c_st(yr+6*sy,c_add(t2,t3));
+		return;
+	}
+	if (N==8) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		c_t t0,t1,t2,t3;
+		c_t t00,t01,t02,t03;
+		c_t t10,t11,t12,t13;
+		c_t tt;
+		t0=c_add(c_ld(xr),c_ld(xr+8));
+		t1=c_add(c_ld(xr+4),c_ld(xr+12));
+		t2=c_sub(c_ld(xr),c_ld(xr+8));
+		t3=c_muli(c_sub(c_ld(xr+4),c_ld(xr+12)));
+		t00=c_add(t0,t1);
+		t01=c_sub(t2,t3);
+		t02=c_sub(t0,t1);
+		t03=c_add(t2,t3);
+		t0=c_add(c_ld(xr+2),c_ld(xr+10));
+		t1=c_add(c_ld(xr+6),c_ld(xr+14));
+		t2=c_sub(c_ld(xr+2),c_ld(xr+10));
+		t3=c_muli(c_sub(c_ld(xr+6),c_ld(xr+14)));
+		t10=c_add(t0,t1);
+		// t11=(t2-t3)*invsqrt2*(1-I);
+		tt=c_sub(t2,t3);
+		t11=c_scale(c_sub(tt,c_muli(tt)),invsqrt2);
+		// t12=(t0-t1)*(-I);
+		t12=c_muli(c_sub(t1,t0));
+		// t13=(t2+t3)*invsqrt2*(-1-I);
+		tt=c_add(t2,t3);
+		t13=c_scale(c_add(tt,c_muli(tt)),-invsqrt2);
+		c_st(yr,c_add(t00,t10));
+		c_st(yr+2*sy,c_add(t01,t11));
+		c_st(yr+4*sy,c_add(t02,t12));
+		c_st(yr+6*sy,c_add(t03,t13));
+		c_st(yr+8*sy,c_sub(t00,t10));
+		c_st(yr+10*sy,c_sub(t01,t11));
+		c_st(yr+12*sy,c_sub(t02,t12));
+		c_st(yr+14*sy,c_sub(t03,t13));
+		return;
+	}
+#else
+	if (N==4) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		// t0=x[0]+x[2];
+		t0r=xr[0]+xr[4];
+		t0i=xi[0]+xi[4];
+		// t1=x[1]+x[3];
+		t1r=xr[2]+xr[6];
+		t1i=xi[2]+xi[6];
+		// t2=x[0]-x[2];
+		t2r=xr[0]-xr[4];
+		t2i=xi[0]-xi[4];
+		// t3=I*(x[1]-x[3]);
+		t3r=-xi[2]+xi[6];
+		t3i=xr[2]-xr[6];
+		// y[0]=t0+t1;
+		yr[0]=t0r+t1r;
+		yi[0]=t0i+t1i;
+		// y[sy]=t2-t3;
+		yr[2*sy]=t2r-t3r;
+		yi[2*sy]=t2i-t3i;
+		// y[2*sy]=t0-t1;
+		yr[4*sy]=t0r-t1r;
+		yi[4*sy]=t0i-t1i;
+		// y[3*sy]=t2+t3;
+		yr[6*sy]=t2r+t3r;
+		yi[6*sy]=t2i+t3i;
+		return;
+	}
+	if (N==8) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		register minfft_real t00r,t01r,t02r,t03r;
+		register minfft_real t00i,t01i,t02i,t03i;
+		register minfft_real t10r,t11r,t12r,t13r;
+		register minfft_real t10i,t11i,t12i,t13i;
+		register minfft_real ttr,tti;
+		// t0=x[0]+x[4];
+		t0r=xr[0]+xr[8];
+		t0i=xi[0]+xi[8];
+		// t1=x[2]+x[6];
+		t1r=xr[4]+xr[12];
+		t1i=xi[4]+xi[12];
+		// t2=x[0]-x[4];
+		t2r=xr[0]-xr[8];
+		t2i=xi[0]-xi[8];
+		// t3=I*(x[2]-x[6]);
+		t3r=-xi[4]+xi[12];
+		t3i=xr[4]-xr[12];
+		// t00=t0+t1;
+		t00r=t0r+t1r;
+		t00i=t0i+t1i;
+		// t01=t2-t3;
+		t01r=t2r-t3r;
+		t01i=t2i-t3i;
+		// t02=t0-t1;
+		t02r=t0r-t1r;
+		t02i=t0i-t1i;
+		// t03=t2+t3;
+		t03r=t2r+t3r;
+		t03i=t2i+t3i;
+		// t0=x[1]+x[5];
+		t0r=xr[2]+xr[10];
+		t0i=xi[2]+xi[10];
+		// t1=x[3]+x[7];
+		t1r=xr[6]+xr[14];
+		t1i=xi[6]+xi[14];
+		// t2=x[1]-x[5];
+		t2r=xr[2]-xr[10];
+		t2i=xi[2]-xi[10];
+		// t3=I*(x[3]-x[7]);
+		t3r=-xi[6]+xi[14];
+		t3i=xr[6]-xr[14];
+		// t10=t0+t1;
+		t10r=t0r+t1r;
+		t10i=t0i+t1i;
+		// t11=(t2-t3)*invsqrt2*(1-I);
+		ttr=t2r-t3r;
+		tti=t2i-t3i;
+		t11r=invsqrt2*(ttr+tti);
+		t11i=invsqrt2*(tti-ttr);
+		// t12=(t0-t1)*(-I);
+		t12r=t0i-t1i;
+		t12i=-t0r+t1r;
+		// t13=(t2+t3)*invsqrt2*(-1-I);
+		ttr=t2r+t3r;
+		tti=t2i+t3i;
+		t13r=invsqrt2*(tti-ttr);
+		t13i=-invsqrt2*(tti+ttr);
+		// y[0]=t00+t10;
+		yr[0]=t00r+t10r;
+		yi[0]=t00i+t10i;
+		// y[sy]=t01+t11;
+		yr[2*sy]=t01r+t11r;
+		yi[2*sy]=t01i+t11i;
+		// y[2*sy]=t02+t12;
+		yr[4*sy]=t02r+t12r;
+		yi[4*sy]=t02i+t12i;
+		// y[3*sy]=t03+t13;
+		yr[6*sy]=t03r+t13r;
+		yi[6*sy]=t03i+t13i;
+		// y[4*sy]=t00-t10;
+		yr[8*sy]=t00r-t10r;
+		yi[8*sy]=t00i-t10i;
+		// y[5*sy]=t01-t11;
+		yr[10*sy]=t01r-t11r;
+		yi[10*sy]=t01i-t11i;
+		// y[6*sy]=t02-t12;
+		yr[12*sy]=t02r-t12r;
+		yi[12*sy]=t02i-t12i;
+		// y[7*sy]=t03-t13;
+		yr[14*sy]=t03r-t13r;
+		yi[14*sy]=t03i-t13i;
+		return;
+	}
+#endif
+	// recursion
+	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *xi=xr+1,*ti=tr+1,*ei=er+1;
+	// prepare sub-transform inputs
+	n=0;
+#ifdef MINFFT_VC
+	// vectorized part
+	for (; n+MINFFT_VC<=N/4; n+=MINFFT_VC) {
+		v_t x0,x1,x2,x3;
+		v_t t2,t3;
+		v_t e0r,e0i,e1r,e1i;
+		x0=v_ld(xr+2*n);
+		x1=v_ld(xr+2*n+N/2);
+		x2=v_ld(xr+2*n+N);
+		x3=v_ld(xr+2*n+3*N/2);
+		t2=v_sub(x0,x2);
+		t3=v_muli(v_sub(x1,x3));
+		v_st(tr+2*n,v_add(x0,x2));
+		v_st(tr+2*n+N/2,v_add(x1,x3));
+		v_ld_e(er+4*n,&e0r,&e0i,&e1r,&e1i);
+		v_st(tr+2*n+N,v_cmul(v_sub(t2,t3),e0r,e0i));
+		v_st(tr+2*n+3*N/2,v_cmul(v_add(t2,t3),e1r,e1i));
+	}
+#endif
+	for (; n<N/4; ++n) {
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		// t0=x[n]+x[n+N/2];
+		t0r=xr[2*n]+xr[2*n+N];
+		t0i=xi[2*n]+xi[2*n+N];
+		// t1=x[n+N/4]+x[n+3*N/4];
+		t1r=xr[2*n+N/2]+xr[2*n+3*N/2];
+		t1i=xi[2*n+N/2]+xi[2*n+3*N/2];
+		// t2=x[n]-x[n+N/2];
+		t2r=xr[2*n]-xr[2*n+N];
+		t2i=xi[2*n]-xi[2*n+N];
+		// t3=I*(x[n+N/4]-x[n+3*N/4]);
+		t3r=-xi[2*n+N/2]+xi[2*n+3*N/2];
+		t3i=xr[2*n+N/2]-xr[2*n+3*N/2];
+		// t[n]=t0;
+		tr[2*n]=t0r;
+		ti[2*n]=t0i;
+		// t[n+N/4]=t1;
+		tr[2*n+N/2]=t1r;
+		ti[2*n+N/2]=t1i;
+		// t[n+N/2]=(t2-t3)*e[2*n];
+		t0r=t2r-t3r;
+		t0i=t2i-t3i;
+		t1r=t2r+t3r;
+		t1i=t2i+t3i;
+		tr[2*n+N]=t0r*er[4*n]-t0i*ei[4*n];
+		ti[2*n+N]=t0r*ei[4*n]+t0i*er[4*n];
+		// t[n+3*N/4]=(t2+t3)*e[2*n+1];
+		tr[2*n+3*N/2]=t1r*er[4*n+2]-t1i*ei[4*n+2];
+		ti[2*n+3*N/2]=t1r*ei[4*n+2]+t1i*er[4*n+2];
+	}
+	// call sub-transforms
+	rs_dft_1d(N/2,t,t,y,2*sy,e+N/2);
+	rs_dft_1d(N/4,t+N/2,t+N/2,y+sy,4*sy,e+3*N/4);
+	rs_dft_1d(N/4,t+3*N/4,t+3*N/4,y+3*sy,4*sy,e+3*N/4);
+}
+
+// strided one-dimensional DFT (inv=0) or inverse DFT (inv=1)
+// by the chirp-z algorithm: with c[n]=exp(I*pi*n^2/N),
+// y[k]=conj(c[k])*sum(x[n]*conj(c[n])*c[k-n]) for the forward transform,
+// and the sum is a cyclic convolution of length M done by DFTs
+inline static void
+s_chirp_1d (int inv, minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N,M=a->sub1->N; // transform and convolution lengths
+	minfft_cmpl *t=ws; // temporary buffer
+	minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+	minfft_real *xi=xr+1,*yi=yr+1;
+	minfft_real *tr=(minfft_real*)t,*cr=a->e; // chirp
+	minfft_real *ti=tr+1,*ci=cr+1;
+	minfft_real *br=cr+2*N,*bi=br+1; // spectrum of the chirp, divided by M
+	register minfft_real ur,ui;
+	// t[n]=x[n]*conj(c[n]), or x[n]*c[n] for inverse
+	for (n=0; n<N; ++n) {
+		ur=xr[2*n];
+		ui=xi[2*n];
+		tr[2*n]=ur*cr[2*n]+(inv?-ui:ui)*ci[2*n];
+		ti[2*n]=ui*cr[2*n]-(inv?-ur:ur)*ci[2*n];
+	}
+	for (; n<M; ++n)
+		tr[2*n]=ti[2*n]=0;
+	// t=invdft(dft(t)*b), with conj(b) for inverse
+	s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+	for (n=0; n<M; ++n) {
+		ur=tr[2*n];
+		ui=ti[2*n];
+		tr[2*n]=ur*br[2*n]-(inv?-ui:ui)*bi[2*n];
+		ti[2*n]=ui*br[2*n]+(inv?-ur:ur)*bi[2*n];
+	}
+	s_invdft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+	// y[k]=conj(c[k])*t[k], or c[k]*t[k] for inverse
+	for (n=0; n<N; ++n) {
+		ur=tr[2*n];
+		ui=ti[2*n];
+		yr[2*sy*n]=ur*cr[2*n]+(inv?-ui:ui)*ci[2*n];
+		yi[2*sy*n]=ui*cr[2*n]-(inv?-ur:ur)*ci[2*n];
+	}
+}
+
+// one-dimensional DFT (inv=0) or inverse DFT (inv=1) by the four-step
+// algorithm: with N=N1*N2, n=N2*n1+n2 and k=k1+N1*k2,
+// y[k]=sum(n2) W_N2^(n2*k2) W_N^(n2*k1) sum(n1) W_N1^(n1*k1) x[n],
+// where W_N=e^(-+2*pi*I/N), so that only transforms of lengths N1 and N2
+// and their data stay in cache, while the whole array is swept four times
+inline static void
+s_bailey_1d (int inv, minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t N1=a->sub1->N,N2=a->sub2->N; // lengths of columns and rows
+	ptrdiff_t n0,b,j,k; // counters
+	ptrdiff_t h,l,dh,dl; // twiddle factor exponent N1*h+l and its increment
+	minfft_cmpl *u=ws; // block buffer
+	minfft_cmpl *t=u+BAILEY_BLK*(N1>N2?N1:N2); // transposed array
+	void *w=sub_ws(ws,a); // workspace of subtransforms
+	minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+	minfft_real *xi=xr+1,*yi=yr+1;
+	minfft_real *ur=(minfft_real*)u,*tr=(minfft_real*)t;
+	minfft_real *ui=ur+1,*ti=tr+1;
+	minfft_real *lr=a->e,*hr=lr+2*N1; // W_N^(N1*h+l)=hi[h]*lo[l]
+	minfft_real *li=lr+1,*hi=hr+1;
+	register minfft_real wr,wi,vr,vi;
+	// columns, in blocks
+	for (n0=0; n0<N2; n0+=BAILEY_BLK) {
+		b=N2-n0<BAILEY_BLK?N2-n0:BAILEY_BLK;
+		// u[N1*j+n1]=x[N2*n1+n0+j]
+		for (k=0; k<N1; ++k)
+			for (j=0; j<b; ++j) {
+				ur[2*N1*j+2*k]=xr[2*(N2*k+n0+j)];
+				ui[2*N1*j+2*k]=xi[2*(N2*k+n0+j)];
+			}
+		for (j=0; j<b; ++j) {
+			if (inv)
+				s_invdft_1d(u+N1*j,u+N1*j,1,a->sub1,w);
+			else
+				s_dft_1d(u+N1*j,u+N1*j,1,a->sub1,w);
+			// u[N1*j+k1]*=W_N^((n0+j)*k1)
+			dh=(n0+j)/N1;
+			dl=(n0+j)%N1;
+			h=l=0;
+			for (k=0; k<N1; ++k) {
+				wr=hr[2*h]*lr[2*l]-hi[2*h]*li[2*l];
+				wi=hr[2*h]*li[2*l]+hi[2*h]*lr[2*l];
+				if (inv)
+					wi=-wi;
+				vr=ur[2*N1*j+2*k];
+				vi=ui[2*N1*j+2*k];
+				ur[2*N1*j+2*k]=vr*wr-vi*wi;
+				ui[2*N1*j+2*k]=vr*wi+vi*wr;
+				h+=dh;
+				l+=dl;
+				if (l>=N1) {
+					l-=N1;
+					++h;
+				}
+				if (h>=N2)
+					h-=N2;
+			}
+		}
+		// t[N2*k1+n0+j]=u[N1*j+k1]
+		for (k=0; k<N1; ++k)
+			for (j=0; j<b; ++j) {
+				tr[2*(N2*k+n0+j)]=ur[2*N1*j+2*k];
+				ti[2*(N2*k+n0+j)]=ui[2*N1*j+2*k];
+			}
+	}
+	// rows, in blocks
+	for (n0=0; n0<N1; n0+=BAILEY_BLK) {
+		b=N1-n0<BAILEY_BLK?N1-n0:BAILEY_BLK;
+		for (j=0; j<b; ++j)
+			if (inv)
+				s_invdft_1d(t+N2*(n0+j),u+j,BAILEY_BLK,a->sub2,w);
+			else
+				s_dft_1d(t+N2*(n0+j),u+j,BAILEY_BLK,a->sub2,w);
+		// y[n0+j+N1*k2]=u[BAILEY_BLK*k2+j]
+		for (k=0; k<N2; ++k)
+			for (j=0; j<b; ++j) {
+				yr[2*sy*(n0+j+N1*k)]=ur[2*BAILEY_BLK*k+2*j];
+				yi[2*sy*(n0+j+N1*k)]=ui[2*BAILEY_BLK*k+2*j];
+			}
+	}
+}
+
+// strided one-dimensional DFT
+inline static void
+s_dft_1d (minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	if (a->alg==ALG_CHIRP)
+		s_chirp_1d(0,x,y,sy,a,ws);
+	else if (a->alg==ALG_BAILEY)
+		s_bailey_1d(0,x,y,sy,a,ws);
+	else
+		rs_dft_1d(a->N,x,ws,y,sy,a->e);
+}
+
+// recursive strided one-dimensional inverse DFT
+inline static void
+rs_invdft_1d (ptrdiff_t N, minfft_cmpl *x, minfft_cmpl *t, minfft_cmpl *y, ptrdiff_t sy, const minfft_cmpl *e) {
+	ptrdiff_t n; // counter
+	if (N&(N-1)) {
+		// the odd factors of N come first
+		if (N%7==0)
+			rs_odd_1d(7,1,N,x,t,y,sy,e);
+		else if (N%5==0)
+			rs_odd_1d(5,1,N,x,t,y,sy,e);
+		else
+			rs_odd_1d(3,1,N,x,t,y,sy,e);
+		return;
+	}
+	// split-radix DIF
+	if (N==1) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		// y[0]=x[0];
+		yr[0]=xr[0];
+		yi[0]=xi[0];
+		return;
+	}
+	if (N==2) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r;
+		register minfft_real t0i,t1i;
+		// t0=x[0]+x[1];
+		t0r=xr[0]+xr[2];
+		t0i=xi[0]+xi[2];
+		// t1=x[0]-x[1];
+		t1r=xr[0]-xr[2];
+		t1i=xi[0]-xi[2];
+		// y[0]=t0;
+		yr[0]=t0r;
+		yi[0]=t0i;
+		// y[sy]=t1;
+		yr[2*sy]=t1r;
+		yi[2*sy]=t1i;
+		return;
+	}
+#ifdef MINFFT_C1
+	if (N==4) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		c_t x0,x1,x2,x3;
+		c_t t0,t1,t2,t3;
+		x0=c_ld(xr);
+		x1=c_ld(xr+2);
+		x2=c_ld(xr+4);
+		x3=c_ld(xr+6);
+		t0=c_add(x0,x2);
+		t1=c_add(x1,x3);
+		t2=c_sub(x0,x2);
+		t3=c_muli(c_sub(x1,x3));
+		c_st(yr,c_add(t0,t1));
+		c_st(yr+2*sy,c_add(t2,t3));
+		c_st(yr+4*sy,c_sub(t0,t1));
+		c_st(yr+6*sy,c_sub(t2,t3));
+		return;
+	}
+	if (N==8) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		c_t t0,t1,t2,t3;
+		c_t t00,t01,t02,t03;
+		c_t t10,t11,t12,t13;
+		c_t tt;
+		t0=c_add(c_ld(xr),c_ld(xr+8));
+		t1=c_add(c_ld(xr+4),c_ld(xr+12));
+		t2=c_sub(c_ld(xr),c_ld(xr+8));
+		t3=c_muli(c_sub(c_ld(xr+4),c_ld(xr+12)));
+		t00=c_add(t0,t1);
+		t01=c_add(t2,t3);
+		t02=c_sub(t0,t1);
+		t03=c_sub(t2,t3);
+		t0=c_add(c_ld(xr+2),c_ld(xr+10));
+		t1=c_add(c_ld(xr+6),c_ld(xr+14));
+		t2=c_sub(c_ld(xr+2),c_ld(xr+10));
+		t3=c_muli(c_sub(c_ld(xr+6),c_ld(xr+14)));
+		t10=c_add(t0,t1);
+		// t11=(t2+t3)*invsqrt2*(1+I);
+		tt=c_add(t2,t3);
+		t11=c_scale(c_add(tt,c_muli(tt)),invsqrt2);
+		// t12=(t0-t1)*I;
+		t12=c_muli(c_sub(t0,t1));
+		// t13=(t2-t3)*invsqrt2*(-1+I);
+		tt=c_sub(t2,t3);
+		t13=c_scale(c_sub(c_muli(tt),tt),invsqrt2);
+		c_st(yr,c_add(t00,t10));
+		c_st(yr+2*sy,c_add(t01,t11));
+		c_st(yr+4*sy,c_add(t02,t12));
+		c_st(yr+6*sy,c_add(t03,t13));
+		c_st(yr+8*sy,c_sub(t00,t10));
+		c_st(yr+10*sy,c_sub(t01,t11));
+		c_st(yr+12*sy,c_sub(t02,t12));
+		c_st(yr+14*sy,c_sub(t03,t13));
+		return;
+	}
+#else
+	if (N==4) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		// t0=x[0]+x[2];
+		t0r=xr[0]+xr[4];
+		t0i=xi[0]+xi[4];
+		// t1=x[1]+x[3];
+		t1r=xr[2]+xr[6];
+		t1i=xi[2]+xi[6];
+		// t2=x[0]-x[2];
+		t2r=xr[0]-xr[4];
+		t2i=xi[0]-xi[4];
+		// t3=I*(x[1]-x[3]);
+		t3r=-xi[2]+xi[6];
+		t3i=xr[2]-xr[6];
+		// y[0]=t0+t1;
+		yr[0]=t0r+t1r;
+		yi[0]=t0i+t1i;
+		// y[sy]=t2+t3;
+		yr[2*sy]=t2r+t3r;
+		yi[2*sy]=t2i+t3i;
+		// y[2*sy]=t0-t1;
+		yr[4*sy]=t0r-t1r;
+		yi[4*sy]=t0i-t1i;
+		// y[3*sy]=t2-t3;
+		yr[6*sy]=t2r-t3r;
+		yi[6*sy]=t2i-t3i;
+		return;
+	}
+	if (N==8) {
+		// terminal case
+		minfft_real *xr=(minfft_real*)x,*yr=(minfft_real*)y;
+		minfft_real *xi=xr+1,*yi=yr+1;
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		register minfft_real t00r,t01r,t02r,t03r;
+		register minfft_real t00i,t01i,t02i,t03i;
+		register minfft_real t10r,t11r,t12r,t13r;
+		register minfft_real t10i,t11i,t12i,t13i;
+		register minfft_real ttr,tti;
+		// t0=x[0]+x[4];
+		t0r=xr[0]+xr[8];
+		t0i=xi[0]+xi[8];
+		// t1=x[2]+x[6];
+		t1r=xr[4]+xr[12];
+		t1i=xi[4]+xi[12];
+		// t2=x[0]-x[4];
+		t2r=xr[0]-xr[8];
+		t2i=xi[0]-xi[8];
+		// t3=I*(x[2]-x[6]);
+		t3r=-xi[4]+xi[12];
+		t3i=xr[4]-xr[12];
+		// t00=t0+t1;
+		t00r=t0r+t1r;
+		t00i=t0i+t1i;
+		// t01=t2+t3;
+		t01r=t2r+t3r;
+		t01i=t2i+t3i;
+		// t02=t0-t1;
+		t02r=t0r-t1r;
+		t02i=t0i-t1i;
+		// t03=t2-t3;
+		t03r=t2r-t3r;
+		t03i=t2i-t3i;
+		// t0=x[1]+x[5];
+		t0r=xr[2]+xr[10];
+		t0i=xi[2]+xi[10];
+		// t1=x[3]+x[7];
+		t1r=xr[6]+xr[14];
+		t1i=xi[6]+xi[14];
+		// t2=x[1]-x[5];
+		t2r=xr[2]-xr[10];
+		t2i=xi[2]-xi[10];
+		// t3=I*(x[3]-x[7]);
+		t3r=-xi[6]+xi[14];
+		t3i=xr[6]-xr[14];
+		// t10=t0+t1;
+		t10r=t0r+t1r;
+		t10i=t0i+t1i;
+		// t11=(t2+t3)*invsqrt2*(1+I);
+		ttr=t2r+t3r;
+		tti=t2i+t3i;
+		t11r=invsqrt2*(ttr-tti);
+		t11i=invsqrt2*(ttr+tti);
+		// t12=(t0-t1)*I;
+		t12r=-t0i+t1i;
+		t12i=t0r-t1r;
+		// t13=(t2-t3)*invsqrt2*(-1+I);
+		ttr=t2r-t3r;
+		tti=t2i-t3i;
+		t13r=-invsqrt2*(ttr+tti);
+		t13i=invsqrt2*(ttr-tti);
+		// y[0]=t00+t10;
+		yr[0]=t00r+t10r;
+		yi[0]=t00i+t10i;
+		// y[sy]=t01+t11;
+		yr[2*sy]=t01r+t11r;
+		yi[2*sy]=t01i+t11i;
+		// y[2*sy]=t02+t12;
+		yr[4*sy]=t02r+t12r;
+		yi[4*sy]=t02i+t12i;
+		// y[3*sy]=t03+t13;
+		yr[6*sy]=t03r+t13r;
+		yi[6*sy]=t03i+t13i;
+		// y[4*sy]=t00-t10;
+		yr[8*sy]=t00r-t10r;
+		yi[8*sy]=t00i-t10i;
+		// y[5*sy]=t01-t11;
+		yr[10*sy]=t01r-t11r;
+		yi[10*sy]=t01i-t11i;
+		// y[6*sy]=t02-t12;
+		yr[12*sy]=t02r-t12r;
+		yi[12*sy]=t02i-t12i;
+		// y[7*sy]=t03-t13;
+		yr[14*sy]=t03r-t13r;
+		yi[14*sy]=t03i-t13i;
+		return;
+	}
+#endif
+	// recursion
+	minfft_real *xr=(minfft_real*)x,*tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *xi=xr+1,*ti=tr+1,*ei=er+1;
+	// prepare sub-transform inputs
+	n=0;
+#ifdef MINFFT_VC
+	// vectorized part
+	for (; n+MINFFT_VC<=N/4; n+=MINFFT_VC) {
+		v_t x0,x1,x2,x3;
+		v_t t2,t3;
+		v_t e0r,e0i,e1r,e1i;
+		x0=v_ld(xr+2*n);
+		x1=v_ld(xr+2*n+N/2);
+		x2=v_ld(xr+2*n+N);
+		x3=v_ld(xr+2*n+3*N/2);
+		t2=v_sub(x0,x2);
+		t3=v_muli(v_sub(x1,x3));
+		v_st(tr+2*n,v_add(x0,x2));
+		v_st(tr+2*n+N/2,v_add(x1,x3));
+		v_ld_e(er+4*n,&e0r,&e0i,&e1r,&e1i);
+		v_st(tr+2*n+N,v_cmulc(v_add(t2,t3),e0r,e0i));
+		v_st(tr+2*n+3*N/2,v_cmulc(v_sub(t2,t3),e1r,e1i));
+	}
+#endif
+	for (; n<N/4; ++n) {
+		register minfft_real t0r,t1r,t2r,t3r;
+		register minfft_real t0i,t1i,t2i,t3i;
+		// t0=x[n]+x[n+N/2];
+		t0r=xr[2*n]+xr[2*n+N];
+		t0i=xi[2*n]+xi[2*n+N];
+		// t1=x[n+N/4]+x[n+3*N/4];
+		t1r=xr[2*n+N/2]+xr[2*n+3*N/2];
+		t1i=xi[2*n+N/2]+xi[2*n+3*N/2];
+		// t2=x[n]-x[n+N/2];
+		t2r=xr[2*n]-xr[2*n+N];
+		t2i=xi[2*n]-xi[2*n+N];
+		// t3=I*(x[n+N/4]-x[n+3*N/4]);
+		t3r=-xi[2*n+N/2]+xi[2*n+3*N/2];
+		t3i=xr[2*n+N/2]-xr[2*n+3*N/2];
+		// t[n]=t0;
+		tr[2*n]=t0r;
+		ti[2*n]=t0i;
+		// t[n+N/4]=t1;
+		tr[2*n+N/2]=t1r;
+		ti[2*n+N/2]=t1i;
+		// t[n+N/2]=(t2+t3)*conj(e[2*n]);
+		t0r=t2r+t3r;
+		t0i=t2i+t3i;
+		t1r=t2r-t3r;
+		t1i=t2i-t3i;
+		tr[2*n+N]=t0r*er[4*n]+t0i*ei[4*n];
+		ti[2*n+N]=-t0r*ei[4*n]+t0i*er[4*n];
+		// t[n+3*N/4]=(t2-t3)*conj(e[2*n+1]);
+		tr[2*n+3*N/2]=t1r*er[4*n+2]+t1i*ei[4*n+2];
+		ti[2*n+3*N/2]=-t1r*ei[4*n+2]+t1i*er[4*n+2];
+	}
+	// call sub-transforms
+	rs_invdft_1d(N/2,t,t,y,2*sy,e+N/2);
+	rs_invdft_1d(N/4,t+N/2,t+N/2,y+sy,4*sy,e+3*N/4);
+	rs_invdft_1d(N/4,t+3*N/4,t+3*N/4,y+3*sy,4*sy,e+3*N/4);
+}
+
+// strided one-dimensional inverse DFT
+inline static void
+s_invdft_1d (minfft_cmpl *x, minfft_cmpl *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	if (a->alg==ALG_CHIRP)
+		s_chirp_1d(1,x,y,sy,a,ws);
+	else if (a->alg==ALG_BAILEY)
+		s_bailey_1d(1,x,y,sy,a,ws);
+	else
+		rs_invdft_1d(a->N,x,ws,y,sy,a->e);
+}
+
+// *** real transforms ***
+
+// strided one-dimensional real DFT
+inline static void
+s_realdft_1d (minfft_real *x, minfft_cmpl *z, ptrdiff_t sz, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *e=a->e; // exponent vector
+	minfft_cmpl *w=(minfft_cmpl*)x; // alias
+	minfft_cmpl *t=ws; // temporary buffer
+	minfft_real *zr=(minfft_real*)z;
+	minfft_real *zi=zr+1;
+	if (N==1) {
+		// trivial case
+		zr[0]=x[0];
+		zi[0]=0;
+		return;
+	}
+	if (N==2) {
+		// trivial case
+		register minfft_real t0,t1;
+		t0=x[0];
+		t1=x[1];
+		// z[0]=t0+t1;
+		zr[0]=t0+t1;
+		zi[0]=0;
+		// z[sz]=t0-t1;
+		zr[2*sz]=t0-t1;
+		zi[2*sz]=0;
+		return;
+	}
+	if (N%2) {
+		// odd length: complex DFT of real inputs
+		minfft_real *tr=(minfft_real*)t,*ti=tr+1;
+		for (n=0; n<N; ++n) {
+			tr[2*n]=x[n];
+			ti[2*n]=0;
+		}
+		s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+		for (n=0; n<=N/2; ++n) {
+			zr[2*sz*n]=tr[2*n];
+			zi[2*sz*n]=ti[2*n];
+		}
+		return;
+	}
+	// reduce to complex DFT of length N/2
+	// do complex DFT
+	s_dft_1d(w,t,1,a->sub1,sub_ws(ws,a));
+	// recover results
+	register minfft_real ur,vr;
+	register minfft_real ui,vi;
+	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *ti=tr+1,*ei=er+1;
+	// u=t[0];
+	ur=tr[0];
+	ui=ti[0];
+	// z[0]=creal(u)+cimag(u);
+	zr[0]=ur+ui;
+	zi[0]=0;
+	// z[sz*N/2]=creal(u)-cimag(u);
+	zr[sz*N]=ur-ui;
+	zi[sz*N]=0;
+	for (n=1; 4*n<N; ++n) {
+		register minfft_real ttr,ter;
+		register minfft_real tti,tei;
+		// u=(t[n]+conj(t[N/2-n]))/2;
+		ur=(tr[2*n]+tr[N-2*n])/2;
+		ui=(ti[2*n]-ti[N-2*n])/2;
+		// v=(t[n]-conj(t[N/2-n]))*e[n]/(2*I);
+		ttr=tr[2*n]-tr[N-2*n];
+		tti=ti[2*n]+ti[N-2*n];
+		ter=ei[2*n]; // te=e[n]/I
+		tei=-er[2*n];
+		vr=(ttr*ter-tti*tei)/2;
+		vi=(ttr*tei+tti*ter)/2;
+		// z[sz*n]=u+v;
+		zr[2*sz*n]=ur+vr;
+		zi[2*sz*n]=ui+vi;
+		// z[sz*(N/2-n)]=conj(u-v);
+		zr[sz*(N-2*n)]=ur-vr;
+		zi[sz*(N-2*n)]=-ui+vi;
+	}
+	if (N%4==0) {
+		// z[sz*N/4]=conj(t[N/4]);
+		zr[sz*N/2]=tr[N/2];
+		zi[sz*N/2]=-ti[N/2];
+	}
+}
+
+// one-dimensional inverse real DFT
+inline static void
+invrealdft_1d (minfft_cmpl *z, minfft_real *y, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *e=a->e; // exponent vector
+	minfft_cmpl *w=(minfft_cmpl*)y; // alias
+	minfft_cmpl *t=ws; // temporary buffer
+	minfft_real *zr=(minfft_real*)z;
+	minfft_real *zi=zr+1;
+	if (N==1) {
+		// trivial case
+		y[0]=zr[0];
+		return;
+	}
+	if (N==2) {
+		// trivial case
+		register minfft_real t0,t1; // temporary values
+		t0=zr[0];
+		t1=zr[2];
+		y[0]=t0+t1;
+		y[1]=t0-t1;
+		return;
+	}
+	if (N%2) {
+		// odd length: inverse complex DFT of Hermitian inputs
+		minfft_real *tr=(minfft_real*)t,*ti=tr+1;
+		tr[0]=zr[0];
+		ti[0]=0;
+		for (n=1; n<=N/2; ++n) {
+			// t[n]=z[n];
+			tr[2*n]=zr[2*n];
+			ti[2*n]=zi[2*n];
+			// t[N-n]=conj(z[n]);
+			tr[2*(N-n)]=zr[2*n];
+			ti[2*(N-n)]=-zi[2*n];
+		}
+		s_invdft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+		for (n=0; n<N; ++n)
+			y[n]=tr[2*n];
+		return;
+	}
+	// reduce to inverse complex DFT of length N/2
+	// prepare complex DFT inputs
+	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *ti=tr+1,*ei=er+1;
+	// t[0]=(z[0]+z[N/2])+I*(z[0]-z[N/2]);
+	tr[0]=zr[0]+zr[N];
+	ti[0]=zr[0]-zr[N];
+	for (n=1; 4*n<N; ++n) {
+		register minfft_real ur,vr;
+		register minfft_real ui,vi;
+		register minfft_real ttr,ter;
+		register minfft_real tti,tei;
+		// u=z[n]+conj(z[N/2-n]);
+		ur=zr[2*n]+zr[N-2*n];
+		ui=zi[2*n]-zi[N-2*n];
+		// v=I*(z[n]-conj(z[N/2-n]))*conj(e[n]);
+		ttr=zr[2*n]-zr[N-2*n];
+		tti=zi[2*n]+zi[N-2*n];
+		ter=ei[2*n]; // te=I*conj(e[n])
+		tei=er[2*n];
+		vr=ttr*ter-tti*tei;
+		vi=ttr*tei+tti*ter;
+		// t[n]=u+v;
+		tr[2*n]=ur+vr;
+		ti[2*n]=ui+vi;
+		// t[N/2-n]=conj(u-v);
+		tr[N-2*n]=ur-vr;
+		ti[N-2*n]=-ui+vi;
+	}
+	if (N%4==0) {
+		// t[N/4]=2*conj(z[N/4]);
+		tr[N/2]=2*zr[N/2];
+		ti[N/2]=-2*zi[N/2];
+	}
+	// do inverse complex DFT
+	s_invdft_1d(t,w,1,a->sub1,sub_ws(ws,a));
+}
+
+// *** real symmetric transforms ***
+
+// strided one-dimensional DCT-2
+inline static void
+s_dct2_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_real *t=ws; // temporary buffer
+	minfft_cmpl *z=(minfft_cmpl*)t; // its alias
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=2*x[0];
+		return;
+	}
+	// reduce to real DFT of length N
+	// prepare sub-transform inputs
+	for (n=0; 2*n<N; ++n)
+		t[n]=x[2*n];
+	for (n=0; 2*n+1<N; ++n)
+		t[N-1-n]=x[2*n+1];
+        // do real DFT in-place
+	s_realdft_1d(t,z,1,a->sub1,sub_ws(ws,a));
+	// recover results
+	minfft_real *er=(minfft_real*)e;
+	minfft_real *ei=er+1;
+	// y[0]=2*creal(z[0]);
+	y[0]=2*t[0];
+	for (n=1; 2*n<N; ++n) {
+		// y[sy*n]=2*creal(z[n]*e[n]);
+		y[sy*n]=2*(t[2*n]*er[2*n]-t[2*n+1]*ei[2*n]);
+		// y[sy*(N-n)]=-2*cimag(z[n]*e[n]);
+		y[sy*(N-n)]=-2*(t[2*n]*ei[2*n]+t[2*n+1]*er[2*n]);
+	}
+	if (N%2==0)
+		// y[sy*N/2]=sqrt2*creal(z[N/2]);
+		y[sy*N/2]=sqrt2*t[N];
+}
+
+// strided one-dimensional DST-2
+inline static void
+s_dst2_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_real *t=ws; // temporary buffer
+	minfft_cmpl *z=(minfft_cmpl*)t; // its alias
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=2*x[0];
+		return;
+	}
+	// reduce to real DFT of length N
+	// prepare sub-transform inputs
+	for (n=0; 2*n<N; ++n)
+		t[n]=x[2*n];
+	for (n=0; 2*n+1<N; ++n)
+		t[N-1-n]=-x[2*n+1];
+        // do real DFT in-place
+	s_realdft_1d(t,z,1,a->sub1,sub_ws(ws,a));
+	// recover results
+	minfft_real *er=(minfft_real*)e;
+	minfft_real *ei=er+1;
+	// y[sy*(N-1)]=2*creal(z[0]);
+	y[sy*(N-1)]=2*t[0];
+	for (n=1; 2*n<N; ++n) {
+		// y[sy*(n-1)]=-2*cimag(z[n]*e[n]);
+		y[sy*(n-1)]=-2*(t[2*n]*ei[2*n]+t[2*n+1]*er[2*n]);
+		// y[sy*(N-n-1)]=2*creal(z[n]*e[n]);
+		y[sy*(N-n-1)]=2*(t[2*n]*er[2*n]-t[2*n+1]*ei[2*n]);
+	}
+	if (N%2==0)
+		// y[sy*(N/2-1)]=sqrt2*creal(z[N/2]);
+		y[sy*(N/2-1)]=sqrt2*t[N];
+}
+
+// strided one-dimensional DCT-3
+inline static void
+s_dct3_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *z=ws; // temporary buffer
+	minfft_real *t=(minfft_real*)z; // its alias
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=x[0];
+		return;
+	}
+	// reduce to inverse real DFT of length N
+	// prepare sub-transform inputs
+	minfft_real *er=(minfft_real*)e,*zr=(minfft_real*)z;
+	minfft_real *ei=er+1,*zi=zr+1;
+	// z[0]=x[0];
+	zr[0]=x[0];
+	zi[0]=0;
+	for (n=1; 2*n<N; ++n) {
+		// z[n]=conj((x[n]+I*x[N-n])*e[n]);
+		zr[2*n]=x[n]*er[2*n]-x[N-n]*ei[2*n];
+		zi[2*n]=-x[n]*ei[2*n]-x[N-n]*er[2*n];
+	}
+	if (N%2==0) {
+		// z[N/2]=sqrt2*x[N/2];
+		zr[N]=sqrt2*x[N/2];
+		zi[N]=0;
+	}
+	// do inverse real DFT in-place
+	invrealdft_1d(z,t,a->sub1,sub_ws(ws,a));
+	// recover results
+	for (n=0; 2*n<N; ++n)
+		y[sy*2*n]=t[n];
+	for (n=0; 2*n+1<N; ++n)
+		y[sy*(2*n+1)]=t[N-1-n];
+}
+
+// strided one-dimensional DST-3
+inline static void
+s_dst3_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *z=ws; // temporary buffer
+	minfft_real *t=(minfft_real*)z; // its alias
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=x[0];
+		return;
+	}
+	// reduce to inverse real DFT of length N
+	// prepare sub-transform inputs
+	minfft_real *er=(minfft_real*)e,*zr=(minfft_real*)z;
+	minfft_real *ei=er+1,*zi=zr+1;
+	// z[0]=x[N-1];
+	zr[0]=x[N-1];
+	zi[0]=0;
+	for (n=1; 2*n<N; ++n) {
+		// z[n]=conj((x[N-n-1]+I*x[n-1])*e[n]);
+		zr[2*n]=x[N-n-1]*er[2*n]-x[n-1]*ei[2*n];
+		zi[2*n]=-x[N-n-1]*ei[2*n]-x[n-1]*er[2*n];
+	}
+	if (N%2==0) {
+		// z[N/2]=sqrt2*x[N/2-1];
+		zr[N]=sqrt2*x[N/2-1];
+		zi[N]=0;
+	}
+	// do inverse real DFT in-place
+	invrealdft_1d(z,t,a->sub1,sub_ws(ws,a));
+	// recover results
+	for (n=0; 2*n<N; ++n)
+		y[sy*2*n]=t[n];
+	for (n=0; 2*n+1<N; ++n)
+		y[sy*(2*n+1)]=-t[N-1-n];
+}
+
+// strided one-dimensional DCT-4
+inline static void
+s_dct4_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *t=ws; // temporary buffer
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=sqrt2*x[0];
+		return;
+	}
+	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *ti=tr+1,*ei=er+1;
+	if (N%2) {
+		// odd length: complex DFT of the same length
+		for (n=0; n<N; ++n) {
+			// t[n]=x[n]*e[n];
+			tr[2*n]=x[n]*er[2*n];
+			ti[2*n]=x[n]*ei[2*n];
+		}
+		s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+		// t[n] are the even outputs 2*n of a DFT of length 2*N,
+		// and y[2*N-1-k]=-y[k]
+		for (n=0; 2*n<N; ++n)
+			// y[sy*2*n]=2*creal(e[N+n]*t[n]);
+			y[sy*2*n]=2*(er[2*(N+n)]*tr[2*n]-ei[2*(N+n)]*ti[2*n]);
+		for (; n<N; ++n)
+			// y[sy*(2*N-1-2*n)]=-2*creal(e[N+n]*t[n]);
+			y[sy*(2*N-1-2*n)]=-2*(er[2*(N+n)]*tr[2*n]-ei[2*(N+n)]*ti[2*n]);
+		return;
+	}
+	// reduce to complex DFT of length N/2
+	// prepare sub-transform inputs
+	for (n=0; n<N/2; ++n) {
+		// t[n]=*e++*(x[2*n]+I*x[N-1-2*n]);
+		tr[2*n]=er[2*n]*x[2*n]-ei[2*n]*x[N-1-2*n];
+		ti[2*n]=er[2*n]*x[N-1-2*n]+ei[2*n]*x[2*n];
+	}
+	// do complex DFT in-place
+	s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+	// recover results
+	er+=N;
+	ei+=N;
+	for (n=0; n<N/2; ++n) {
+		// y[sy*2*n]=2*creal(*e++*t[n]);
+		y[sy*2*n]=2*(er[4*n]*tr[2*n]-ei[4*n]*ti[2*n]);
+		// y[sy*(2*n+1)]=2*creal(*e++*conj(t[N/2-1-n]));
+		y[sy*(2*n+1)]=2*(er[4*n+2]*tr[N-2-2*n]+ei[4*n+2]*ti[N-2-2*n]);
+	}
+}
+
+// strided one-dimensional DST-4
+inline static void
+s_dst4_1d (minfft_real *x, minfft_real *y, ptrdiff_t sy, const minfft_aux *a, void *ws) {
+	ptrdiff_t n; // counter
+	ptrdiff_t N=a->N; // transform length
+	minfft_cmpl *t=ws; // temporary buffer
+	minfft_cmpl *e=a->e; // exponent vector
+	if (N==1) {
+		// trivial case
+		y[0]=sqrt2*x[0];
+		return;
+	}
+	minfft_real *tr=(minfft_real*)t,*er=(minfft_real*)e;
+	minfft_real *ti=tr+1,*ei=er+1;
+	if (N%2) {
+		// odd length: complex DFT of the same length
+		for (n=0; n<N; ++n) {
+			// t[n]=x[n]*e[n];
+			tr[2*n]=x[n]*er[2*n];
+			ti[2*n]=x[n]*ei[2*n];
+		}
+		s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+		// t[n] are the even outputs 2*n of a DFT of length 2*N,
+		// and y[2*N-1-k]=y[k]
+		for (n=0; 2*n<N; ++n)
+			// y[sy*2*n]=-2*cimag(e[N+n]*t[n]);
+			y[sy*2*n]=-2*(er[2*(N+n)]*ti[2*n]+ei[2*(N+n)]*tr[2*n]);
+		for (; n<N; ++n)
+			// y[sy*(2*N-1-2*n)]=-2*cimag(e[N+n]*t[n]);
+			y[sy*(2*N-1-2*n)]=-2*(er[2*(N+n)]*ti[2*n]+ei[2*(N+n)]*tr[2*n]);
+		return;
+	}
+	// reduce to complex DFT of length N/2
+	// prepare sub-transform inputs
+	for (n=0; n<N/2; ++n) {
+		// t[n]=-*e++*(x[2*n]-I*x[N-1-2*n]);
+		tr[2*n]=-er[2*n]*x[2*n]-ei[2*n]*x[N-1-2*n];
+		ti[2*n]=er[2*n]*x[N-1-2*n]-ei[2*n]*x[2*n];
+	}
+	// do complex DFT in-place
+	s_dft_1d(t,t,1,a->sub1,sub_ws(ws,a));
+	// recover results
+	er+=N;
+	ei+=N;
+	for (n=0; n<N/2; ++n) {
+		// y[sy*2*n]=2*cimag(*e++*t[n]);
+		y[sy*2*n]=2*(er[4*n]*ti[2*n]+ei[4*n]*tr[2*n]);
+		// y[sy*(2*n+1)]=2*cimag(*e++*conj(t[N/2-1-n]));
+		y[sy*(2*n+1)]=2*(-er[4*n+2]*ti[N-2-2*n]+ei[4*n+2]*tr[N-2-2*n]);
+	}
+}
+
+// *** kernel table ***
+
+const struct minfft_kernels MINFFT_KERNELS={
+	s_dft_1d,s_invdft_1d,
+	s_realdft_1d,invrealdft_1d,
+	s_dct2_1d,s_dst2_1d,s_dct3_1d,s_dst3_1d,s_dct4_1d,s_dst4_1d
+};
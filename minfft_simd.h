@@ -0,0 +1,297 @@
+// A minimalistic FFT library
+// Copyright (c) 2016-2022 Alexander Mukhin
+// SPDX-License-Identifier: MIT
+
+// SIMD operations on interleaved complex numbers,
+// internal to the library
+
+#ifndef MINFFT_SIMD_H
+#define MINFFT_SIMD_H
+
+// The instruction set is selected at compile time by the predefined
+// macros of the compiler, e.g. by the -march option of GCC.
+//
+// Vectors of MINFFT_VC complex numbers (type v_t) are used for loops
+// over contiguous data. Single complex numbers (type c_t) are used for
+// straight-line code. If no SIMD is available, MINFFT_VC and
+// MINFFT_C1 are left undefined.
+
+#if !defined(MINFFT_NO_SIMD) && !MINFFT_EXTENDED
+
+#if defined(__AVX512F__)
+#define MINFFT_AVX512 1
+#elif defined(__AVX__)
+#define MINFFT_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#define MINFFT_SSE2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#define MINFFT_NEON 1
+#endif
+
+#if MINFFT_AVX512 || MINFFT_AVX
+#include <immintrin.h>
+#elif MINFFT_SSE2
+#include <emmintrin.h>
+#elif MINFFT_NEON
+#include <arm_neon.h>
+#endif
+
+// *** vectors of complex numbers ***
+
+#if MINFFT_AVX512 && MINFFT_SINGLE
+#define MINFFT_VC 8
+typedef __m512 v_t;
+#define v_ld(p) _mm512_loadu_ps(p)
+#define v_st(p,a) _mm512_storeu_ps((p),(a))
+#define v_add(a,b) _mm512_add_ps((a),(b))
+#define v_sub(a,b) _mm512_sub_ps((a),(b))
+#define v_mul(a,b) _mm512_mul_ps((a),(b))
+#define v_swap(a) _mm512_permute_ps((a),0xB1)
+#define v_set1(s) _mm512_set1_ps(s)
+#define v_dup_re(a) _mm512_moveldup_ps(a)
+#define v_dup_im(a) _mm512_movehdup_ps(a)
+#define v_xor(a,m) _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),(m)))
+#define v_neg_re(a) v_xor((a),_mm512_set1_epi64((long long)0x80000000))
+#define v_neg_im(a) v_xor((a),_mm512_set1_epi64((long long)0x8000000000000000ULL))
+// load exponents e[4*n..4*n+4*VC) as duplicated real and imaginary parts
+static inline void
+v_ld_e (const float *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	const __m512i i0=_mm512_set_epi64(14,12,10,8,6,4,2,0);
+	const __m512i i1=_mm512_set_epi64(15,13,11,9,7,5,3,1);
+	__m512d a=_mm512_loadu_pd((const double*)e);
+	__m512d b=_mm512_loadu_pd((const double*)(e+16));
+	__m512 e0=_mm512_castpd_ps(_mm512_permutex2var_pd(a,i0,b));
+	__m512 e1=_mm512_castpd_ps(_mm512_permutex2var_pd(a,i1,b));
+	*e0r=_mm512_moveldup_ps(e0);
+	*e0i=_mm512_movehdup_ps(e0);
+	*e1r=_mm512_moveldup_ps(e1);
+	*e1i=_mm512_movehdup_ps(e1);
+}
+
+#elif MINFFT_AVX512
+#define MINFFT_VC 4
+typedef __m512d v_t;
+#define v_ld(p) _mm512_loadu_pd(p)
+#define v_st(p,a) _mm512_storeu_pd((p),(a))
+#define v_add(a,b) _mm512_add_pd((a),(b))
+#define v_sub(a,b) _mm512_sub_pd((a),(b))
+#define v_mul(a,b) _mm512_mul_pd((a),(b))
+#define v_swap(a) _mm512_permute_pd((a),0x55)
+#define v_set1(s) _mm512_set1_pd(s)
+#define v_dup_re(a) _mm512_movedup_pd(a)
+#define v_dup_im(a) _mm512_permute_pd((a),0xFF)
+#define v_xor(a,m) _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a),(m)))
+#define v_neg_re(a) v_xor((a),_mm512_set4_epi64(0,(long long)0x8000000000000000ULL,0,(long long)0x8000000000000000ULL))
+#define v_neg_im(a) v_xor((a),_mm512_set4_epi64((long long)0x8000000000000000ULL,0,(long long)0x8000000000000000ULL,0))
+static inline void
+v_ld_e (const double *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	__m512d a=_mm512_loadu_pd(e);
+	__m512d b=_mm512_loadu_pd(e+8);
+	__m512d e0=_mm512_shuffle_f64x2(a,b,0x88);
+	__m512d e1=_mm512_shuffle_f64x2(a,b,0xDD);
+	*e0r=_mm512_movedup_pd(e0);
+	*e0i=_mm512_permute_pd(e0,0xFF);
+	*e1r=_mm512_movedup_pd(e1);
+	*e1i=_mm512_permute_pd(e1,0xFF);
+}
+
+#elif MINFFT_AVX && MINFFT_SINGLE
+#define MINFFT_VC 4
+typedef __m256 v_t;
+#define v_ld(p) _mm256_loadu_ps(p)
+#define v_st(p,a) _mm256_storeu_ps((p),(a))
+#define v_add(a,b) _mm256_add_ps((a),(b))
+#define v_sub(a,b) _mm256_sub_ps((a),(b))
+#define v_mul(a,b) _mm256_mul_ps((a),(b))
+#define v_swap(a) _mm256_permute_ps((a),0xB1)
+#define v_set1(s) _mm256_set1_ps(s)
+#define v_dup_re(a) _mm256_moveldup_ps(a)
+#define v_dup_im(a) _mm256_movehdup_ps(a)
+#define v_neg_re(a) _mm256_xor_ps((a),_mm256_setr_ps(-0.0f,0,-0.0f,0,-0.0f,0,-0.0f,0))
+#define v_neg_im(a) _mm256_xor_ps((a),_mm256_setr_ps(0,-0.0f,0,-0.0f,0,-0.0f,0,-0.0f))
+static inline void
+v_ld_e (const float *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	__m256d a=_mm256_loadu_pd((const double*)e);
+	__m256d b=_mm256_loadu_pd((const double*)(e+8));
+	__m256d p=_mm256_permute2f128_pd(a,b,0x20);
+	__m256d q=_mm256_permute2f128_pd(a,b,0x31);
+	__m256 e0=_mm256_castpd_ps(_mm256_unpacklo_pd(p,q));
+	__m256 e1=_mm256_castpd_ps(_mm256_unpackhi_pd(p,q));
+	*e0r=_mm256_moveldup_ps(e0);
+	*e0i=_mm256_movehdup_ps(e0);
+	*e1r=_mm256_moveldup_ps(e1);
+	*e1i=_mm256_movehdup_ps(e1);
+}
+
+#elif MINFFT_AVX
+#define MINFFT_VC 2
+typedef __m256d v_t;
+#define v_ld(p) _mm256_loadu_pd(p)
+#define v_st(p,a) _mm256_storeu_pd((p),(a))
+#define v_add(a,b) _mm256_add_pd((a),(b))
+#define v_sub(a,b) _mm256_sub_pd((a),(b))
+#define v_mul(a,b) _mm256_mul_pd((a),(b))
+#define v_swap(a) _mm256_permute_pd((a),0x5)
+#define v_set1(s) _mm256_set1_pd(s)
+#define v_dup_re(a) _mm256_movedup_pd(a)
+#define v_dup_im(a) _mm256_permute_pd((a),0xF)
+#define v_neg_re(a) _mm256_xor_pd((a),_mm256_setr_pd(-0.0,0,-0.0,0))
+#define v_neg_im(a) _mm256_xor_pd((a),_mm256_setr_pd(0,-0.0,0,-0.0))
+static inline void
+v_ld_e (const double *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	__m256d a=_mm256_loadu_pd(e);
+	__m256d b=_mm256_loadu_pd(e+4);
+	__m256d e0=_mm256_permute2f128_pd(a,b,0x20);
+	__m256d e1=_mm256_permute2f128_pd(a,b,0x31);
+	*e0r=_mm256_movedup_pd(e0);
+	*e0i=_mm256_permute_pd(e0,0xF);
+	*e1r=_mm256_movedup_pd(e1);
+	*e1i=_mm256_permute_pd(e1,0xF);
+}
+
+#elif MINFFT_SSE2 && MINFFT_SINGLE
+#define MINFFT_VC 2
+typedef __m128 v_t;
+#define v_ld(p) _mm_loadu_ps(p)
+#define v_st(p,a) _mm_storeu_ps((p),(a))
+#define v_add(a,b) _mm_add_ps((a),(b))
+#define v_sub(a,b) _mm_sub_ps((a),(b))
+#define v_mul(a,b) _mm_mul_ps((a),(b))
+#define v_swap(a) _mm_shuffle_ps((a),(a),_MM_SHUFFLE(2,3,0,1))
+#define v_set1(s) _mm_set1_ps(s)
+#define v_dup_re(a) _mm_shuffle_ps((a),(a),_MM_SHUFFLE(2,2,0,0))
+#define v_dup_im(a) _mm_shuffle_ps((a),(a),_MM_SHUFFLE(3,3,1,1))
+#define v_neg_re(a) _mm_xor_ps((a),_mm_setr_ps(-0.0f,0,-0.0f,0))
+#define v_neg_im(a) _mm_xor_ps((a),_mm_setr_ps(0,-0.0f,0,-0.0f))
+static inline void
+v_ld_e (const float *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	__m128 a=_mm_loadu_ps(e);
+	__m128 b=_mm_loadu_ps(e+4);
+	__m128 e0=_mm_movelh_ps(a,b);
+	__m128 e1=_mm_movehl_ps(b,a);
+	*e0r=_mm_shuffle_ps(e0,e0,_MM_SHUFFLE(2,2,0,0));
+	*e0i=_mm_shuffle_ps(e0,e0,_MM_SHUFFLE(3,3,1,1));
+	*e1r=_mm_shuffle_ps(e1,e1,_MM_SHUFFLE(2,2,0,0));
+	*e1i=_mm_shuffle_ps(e1,e1,_MM_SHUFFLE(3,3,1,1));
+}
+
+#elif MINFFT_SSE2
+#define MINFFT_VC 1
+typedef __m128d v_t;
+#define v_ld(p) _mm_loadu_pd(p)
+#define v_st(p,a) _mm_storeu_pd((p),(a))
+#define v_add(a,b) _mm_add_pd((a),(b))
+#define v_sub(a,b) _mm_sub_pd((a),(b))
+#define v_mul(a,b) _mm_mul_pd((a),(b))
+#define v_swap(a) _mm_shuffle_pd((a),(a),1)
+#define v_set1(s) _mm_set1_pd(s)
+#define v_dup_re(a) _mm_unpacklo_pd((a),(a))
+#define v_dup_im(a) _mm_unpackhi_pd((a),(a))
+#define v_neg_re(a) _mm_xor_pd((a),_mm_setr_pd(-0.0,0))
+#define v_neg_im(a) _mm_xor_pd((a),_mm_setr_pd(0,-0.0))
+static inline void
+v_ld_e (const double *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	__m128d e0=_mm_loadu_pd(e);
+	__m128d e1=_mm_loadu_pd(e+2);
+	*e0r=_mm_unpacklo_pd(e0,e0);
+	*e0i=_mm_unpackhi_pd(e0,e0);
+	*e1r=_mm_unpacklo_pd(e1,e1);
+	*e1i=_mm_unpackhi_pd(e1,e1);
+}
+
+#elif MINFFT_NEON && MINFFT_SINGLE
+#define MINFFT_VC 2
+typedef float32x4_t v_t;
+#define v_ld(p) vld1q_f32(p)
+#define v_st(p,a) vst1q_f32((p),(a))
+#define v_add(a,b) vaddq_f32((a),(b))
+#define v_sub(a,b) vsubq_f32((a),(b))
+#define v_mul(a,b) vmulq_f32((a),(b))
+#define v_swap(a) vrev64q_f32(a)
+#define v_set1(s) vdupq_n_f32(s)
+#define v_dup_re(a) vtrn1q_f32((a),(a))
+#define v_dup_im(a) vtrn2q_f32((a),(a))
+#define v_xor(a,m) vreinterpretq_f32_u64(veorq_u64(vreinterpretq_u64_f32(a),vdupq_n_u64(m)))
+#define v_neg_re(a) v_xor((a),0x80000000ULL)
+#define v_neg_im(a) v_xor((a),0x8000000000000000ULL)
+static inline void
+v_ld_e (const float *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	float32x4_t a=vld1q_f32(e);
+	float32x4_t b=vld1q_f32(e+4);
+	float32x4_t e0=vcombine_f32(vget_low_f32(a),vget_low_f32(b));
+	float32x4_t e1=vcombine_f32(vget_high_f32(a),vget_high_f32(b));
+	*e0r=vtrn1q_f32(e0,e0);
+	*e0i=vtrn2q_f32(e0,e0);
+	*e1r=vtrn1q_f32(e1,e1);
+	*e1i=vtrn2q_f32(e1,e1);
+}
+
+#elif MINFFT_NEON
+#define MINFFT_VC 1
+typedef float64x2_t v_t;
+#define v_ld(p) vld1q_f64(p)
+#define v_st(p,a) vst1q_f64((p),(a))
+#define v_add(a,b) vaddq_f64((a),(b))
+#define v_sub(a,b) vsubq_f64((a),(b))
+#define v_mul(a,b) vmulq_f64((a),(b))
+#define v_swap(a) vextq_f64((a),(a),1)
+#define v_set1(s) vdupq_n_f64(s)
+#define v_dup_re(a) vdupq_laneq_f64((a),0)
+#define v_dup_im(a) vdupq_laneq_f64((a),1)
+#define v_xor(a,m0,m1) vreinterpretq_f64_u64(veorq_u64(vreinterpretq_u64_f64(a),vcombine_u64(vcreate_u64(m0),vcreate_u64(m1))))
+#define v_neg_re(a) v_xor((a),0x8000000000000000ULL,0)
+#define v_neg_im(a) v_xor((a),0,0x8000000000000000ULL)
+static inline void
+v_ld_e (const double *e, v_t *e0r, v_t *e0i, v_t *e1r, v_t *e1i) {
+	float64x2_t e0=vld1q_f64(e);
+	float64x2_t e1=vld1q_f64(e+2);
+	*e0r=vdupq_laneq_f64(e0,0);
+	*e0i=vdupq_laneq_f64(e0,1);
+	*e1r=vdupq_laneq_f64(e1,0);
+	*e1i=vdupq_laneq_f64(e1,1);
+}
+#endif
+
+#ifdef MINFFT_VC
+// I*a
+#define v_muli(a) v_neg_re(v_swap(a))
+// a*e, with duplicated real and imaginary parts of e
+#define v_cmul(a,er,ei) v_add(v_mul((a),(er)),v_neg_re(v_mul(v_swap(a),(ei))))
+// a*conj(e)
+#define v_cmulc(a,er,ei) v_add(v_mul((a),(er)),v_neg_im(v_mul(v_swap(a),(ei))))
+// a*w and a*conj(w), with interleaved w
+#define v_cmulw(a,w) v_cmul((a),v_dup_re(w),v_dup_im(w))
+#define v_cmulwc(a,w) v_cmulc((a),v_dup_re(w),v_dup_im(w))
+#endif
+
+// *** single complex numbers ***
+
+#if MINFFT_VC==1
+// vectors hold one complex number
+#define MINFFT_C1 1
+typedef v_t c_t;
+#define c_ld(p) v_ld(p)
+#define c_st(p,a) v_st((p),(a))
+#define c_add(a,b) v_add((a),(b))
+#define c_sub(a,b) v_sub((a),(b))
+#define c_muli(a) v_muli(a)
+#if MINFFT_NEON
+#define c_scale(a,s) vmulq_n_f64((a),(s))
+#else
+#define c_scale(a,s) _mm_mul_pd((a),_mm_set1_pd(s))
+#endif
+#elif (MINFFT_AVX512 || MINFFT_AVX) && !MINFFT_SINGLE
+// use the SSE2 part of AVX
+#define MINFFT_C1 1
+typedef __m128d c_t;
+#define c_ld(p) _mm_loadu_pd(p)
+#define c_st(p,a) _mm_storeu_pd((p),(a))
+#define c_add(a,b) _mm_add_pd((a),(b))
+#define c_sub(a,b) _mm_sub_pd((a),(b))
+#define c_muli(a) _mm_xor_pd(_mm_shuffle_pd((a),(a),1),_mm_setr_pd(-0.0,0))
+#define c_scale(a,s) _mm_mul_pd((a),_mm_set1_pd(s))
+#endif
+
+#endif // !MINFFT_NO_SIMD && !MINFFT_EXTENDED
+
+#endif // MINFFT_SIMD_H
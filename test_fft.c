@@ -2,6 +2,7 @@
 #include "minfft.h"
 
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -44,6 +45,28 @@ minfft_real abs_max(int N, const minfft_real *a);
 int max_idx(int N, const minfft_real *a);
 
 
+/* task dispatcher running the tasks sequentially, in reverse order */
+static void run_tasks(minfft_task *task, void *arg, int ntasks, void *ctx)
+{
+    int k;
+    (void)ctx;
+    for (k = ntasks - 1; k >= 0; --k)
+        task(arg, k);
+}
+
+/* allocator hooks counting the live blocks in *ctx */
+static void *count_alloc(size_t size, void *ctx)
+{
+    ++*(int *)ctx;
+    return malloc(size);
+}
+
+static void count_dealloc(void *p, void *ctx)
+{
+    --*(int *)ctx;
+    free(p);
+}
+
 static inline minfft_real * c2r(minfft_cmpl * c)
 {
     void *v = c;
@@ -71,7 +94,7 @@ int main(int argc, char *argv[])
     else
     {
         fprintf(stderr, "usage: %s <N>\n", argv[0]);
-        fprintf(stderr, "  N = data length: must be 2^m\n");
+        fprintf(stderr, "  N = data length: any positive number\n");
         return 1;
     }
 
@@ -141,8 +164,226 @@ int main(int argc, char *argv[])
         printf("complex carrier %d: max %g at %d;  max2 %g at %d --> err %d\n",
             k, (double)maxval, mi, (double)max2, ni, ret);
     }
+
+    /* check: transform with caller-owned workspace equals transform with aux workspace? */
+    {
+        void *ws = malloc(minfft_workspace_size(prep_min_ftz));
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        putdata(2 * n, c2r(zr));
+        minfft_dft(zr, Xz, prep_min_ftz);
+        minfft_dft_ws(zr, zi, prep_min_ftz, ws);
+        for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+            ;
+        ret = (j < 2 * n) ? 1 : 0;
+        retCode += ret;
+        printf("complex dft with caller-owned workspace of %u bytes --> err %d\n",
+            (unsigned)minfft_workspace_size(prep_min_ftz), ret);
+        free(ws);
+    }
     minfft_free_aux(prep_min_ftz);
 
+    /* check: 2d transform split into tasks equals 2d transform in a single task? */
+    if (n % 4 == 0)
+    {
+        minfft_aux *prep_2d = minfft_mkaux_dft_2d(4, n / 4);
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        putdata(2 * n, c2r(zr));
+        minfft_dft(zr, Xz, prep_2d);
+        ret = minfft_set_dispatch(prep_2d, 3, run_tasks, NULL) ? 1 : 0;
+        minfft_dft(zr, zi, prep_2d);
+        for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+            ;
+        ret += (j < 2 * n) ? 1 : 0;
+        retCode += ret;
+        printf("complex 2d dft split into 3 tasks --> err %d\n", ret);
+        minfft_free_aux(prep_2d);
+    }
+
+    /* check: makers with 64-bit lengths agree with int makers and reject overflowing sizes? */
+    {
+        ptrdiff_t Ns[2] = { 1, n };
+        minfft_aux *prep_64 = minfft_mkaux_dft_64(2, Ns);
+        minfft_aux *prep_1d = minfft_mkaux_dft_1d(n);
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        putdata(2 * n, c2r(zr));
+        minfft_dft(zr, Xz, prep_1d);
+        minfft_dft(zr, zi, prep_64);
+        for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+            ;
+        ret = (j < 2 * n) ? 1 : 0;
+        Ns[0] = PTRDIFF_MAX / n + 1;
+        ret += minfft_mkaux_dft_64(2, Ns) != NULL;
+        retCode += ret;
+        printf("complex dft made with 64-bit lengths --> err %d\n", ret);
+        minfft_free_aux(prep_64);
+        minfft_free_aux(prep_1d);
+    }
+
+    /* check: aux data from allocator hooks give the same transform and are freed? */
+    {
+        int live = 0;
+        minfft_aux *prep_1d = minfft_mkaux_dft_1d(n);
+        minfft_aux *prep_hook;
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        ret = minfft_set_alloc(count_alloc, count_dealloc, &live) ? 1 : 0;
+        prep_hook = minfft_mkaux_dft_1d(n);
+        ret += minfft_set_alloc(NULL, NULL, NULL) ? 1 : 0;
+        ret += (live == 0);
+        putdata(2 * n, c2r(zr));
+        minfft_dft(zr, Xz, prep_1d);
+        minfft_dft(zr, zi, prep_hook);
+        for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+            ;
+        ret += (j < 2 * n) ? 1 : 0;
+        minfft_free_aux(prep_hook);
+        ret += (live != 0);
+        retCode += ret;
+        printf("complex dft with allocator hooks --> err %d\n", ret);
+        minfft_free_aux(prep_1d);
+    }
+
+    /* check: aux data of equal transforms share their tree, until the last one is freed? */
+    {
+        int live = 0, live1;
+        minfft_aux *prep_a, *prep_b;
+
+        minfft_set_alloc(count_alloc, count_dealloc, &live);
+        prep_a = minfft_mkaux_t2t3_2d(2, n);
+        live1 = live;
+        prep_b = minfft_mkaux_t2t3_2d(2, n);
+        minfft_set_alloc(NULL, NULL, NULL);
+        ret = (prep_a == NULL || prep_b == NULL);
+        /* the second one takes a single block for itself */
+        ret += (live != live1 + 1);
+        minfft_free_aux(prep_a);
+        ret += (live != live1);
+        minfft_free_aux(prep_b);
+        ret += (live != 0);
+        retCode += ret;
+        printf("cached 2d dct-2 aux data --> err %d\n", ret);
+    }
+
+    /* check: aux data imported from an exported image give the same transform? */
+    {
+        minfft_aux *prep_2d = minfft_mkaux_dft_2d(1, n);
+        size_t len = minfft_export(prep_2d, NULL, 0);
+        char *img = (char *)malloc(len);
+        minfft_aux *prep_imp;
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        ret = (minfft_export(prep_2d, img, len) != len);
+        prep_imp = minfft_import(img, len);
+        ret += (prep_imp == NULL);
+        if (prep_imp != NULL) {
+            putdata(2 * n, c2r(zr));
+            minfft_dft(zr, Xz, prep_2d);
+            minfft_dft(zr, zi, prep_imp);
+            for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+                ;
+            ret += (j < 2 * n) ? 1 : 0;
+            minfft_free_aux(prep_imp);
+        }
+        /* images of other versions are rejected */
+        img[8] ^= 1;
+        ret += (minfft_import(img, len) != NULL);
+        retCode += ret;
+        printf("complex 2d dft imported from %u bytes --> err %d\n", (unsigned)len, ret);
+        minfft_free_aux(prep_2d);
+        free(img);
+    }
+
+    /* check: aux data made in caller's memory give the same transform without allocations? */
+    {
+        int live = 0;
+        ptrdiff_t Ns[1] = { n };
+        minfft_aux *prep_1d = minfft_mkaux_dft_1d(n);
+        size_t len = minfft_aux_size(prep_1d);
+        char *buf = (char *)malloc(len + 1);
+        minfft_aux *prep_into;
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+
+        ret = (minfft_mkaux_dft_into(1, Ns, buf + 1, len / 2) != NULL);
+        minfft_set_alloc(count_alloc, count_dealloc, &live);
+        prep_into = minfft_mkaux_dft_into(1, Ns, buf + 1, len);
+        minfft_set_alloc(NULL, NULL, NULL);
+        ret += (prep_into == NULL || live != 0);
+        if (prep_into != NULL) {
+            putdata(2 * n, c2r(zr));
+            minfft_dft(zr, Xz, prep_1d);
+            minfft_dft(zr, zi, prep_into);
+            for (j = 0; j < 2 * n && a[j] == b[j]; ++j)
+                ;
+            ret += (j < 2 * n) ? 1 : 0;
+            minfft_free_aux(prep_into);
+        }
+        retCode += ret;
+        printf("complex dft made in %u bytes of caller's memory --> err %d\n", (unsigned)len, ret);
+        minfft_free_aux(prep_1d);
+        free(buf);
+    }
+
+    /* check: batch of 2 interleaved transforms equals separate transforms? */
+    if (n % 2 == 0)
+    {
+        const int m = n / 2;
+        minfft_aux *prep_many = minfft_mkaux_dft_many(m, 2, 2, 1, 2, 1);
+        minfft_aux *prep_1d = minfft_mkaux_dft_1d(m);
+        minfft_real *a = c2r(Xz);
+        minfft_real *b = c2r(zi);
+        int l;
+
+        putdata(2 * n, c2r(zr));
+        ret = minfft_set_dispatch(prep_many, 2, run_tasks, NULL) ? 1 : 0;
+        minfft_dft_many(zr, Xz, prep_many);
+        for (l = 0; l < 2; ++l) {
+            /* zi[0..m): l-th input line, zi[m..2m): its spectrum */
+            for (j = 0; j < 2 * m; ++j)
+                b[j] = c2r(zr)[4 * (j / 2) + 2 * l + j % 2];
+            minfft_dft(zi, zi + m, prep_1d);
+            for (j = 0; j < 2 * m && a[4 * (j / 2) + 2 * l + j % 2] == b[2 * m + j]; ++j)
+                ;
+            ret += (j < 2 * m) ? 1 : 0;
+        }
+        retCode += ret;
+        printf("batch of 2 complex dfts with stride 2 --> err %d\n", ret);
+        minfft_free_aux(prep_many);
+        minfft_free_aux(prep_1d);
+
+        prep_many = minfft_mkaux_realdft_many(m, 2, 2, 1, 1, m / 2 + 1);
+        prep_1d = minfft_mkaux_realdft_1d(m);
+        putdata(n, xr);
+        minfft_realdft_many(xr, Xz, prep_many);
+        minfft_invrealdft_many(Xz, xi, prep_many);
+        ret = 0;
+        for (l = 0; l < 2; ++l) {
+            /* b[0..m): l-th input line, zi + m: its spectrum */
+            for (j = 0; j < m; ++j)
+                b[j] = xr[2 * j + l];
+            minfft_realdft(b, zi + m, prep_1d);
+            for (j = 0; j < 2 * (m / 2 + 1) && a[2 * (m / 2 + 1) * l + j] == b[2 * m + j]; ++j)
+                ;
+            ret += (j < 2 * (m / 2 + 1)) ? 1 : 0;
+            minfft_invrealdft(zi + m, b, prep_1d);
+            for (j = 0; j < m && xi[2 * j + l] == b[j]; ++j)
+                ;
+            ret += (j < m) ? 1 : 0;
+        }
+        retCode += ret;
+        printf("batch of 2 real dfts with stride 2 --> err %d\n", ret);
+        minfft_free_aux(prep_many);
+        minfft_free_aux(prep_1d);
+    }
+
     /* check of RDFT */
     putdata(n, xr);
     mx = abs_max(n, xr);